@@ -29,6 +29,10 @@ ifdef MOUSEKEY_ENABLE
     OPT_DEFS += -DMOUSE_ENABLE
 endif
 
+ifdef MOUSE_16BIT_ENABLE
+    OPT_DEFS += -DMOUSE_16BIT_ENABLE
+endif
+
 ifdef EXTRAKEY_ENABLE
     OPT_DEFS += -DEXTRAKEY_ENABLE
 endif
@@ -45,6 +49,37 @@ ifdef COMMAND_ENABLE
     OPT_DEFS += -DCOMMAND_ENABLE
 endif
 
+ifdef KEY_STATS_ENABLE
+    SRC += $(COMMON_DIR)/key_stats.c
+    OPT_DEFS += -DKEY_STATS_ENABLE
+endif
+
+ifdef KEY_REPEAT_ENABLE
+    SRC += $(COMMON_DIR)/key_repeat.c
+    OPT_DEFS += -DKEY_REPEAT_ENABLE
+endif
+
+ifdef DYNAMIC_MACRO_ENABLE
+    SRC += $(COMMON_DIR)/dynamic_macro.c
+    OPT_DEFS += -DDYNAMIC_MACRO_ENABLE
+endif
+
+ifdef STENO_ENABLE
+    SRC += $(COMMON_DIR)/steno.c
+    SRC += steno_dict.c
+    OPT_DEFS += -DSTENO_ENABLE
+endif
+
+ifdef COMBO_ENABLE
+    SRC += $(COMMON_DIR)/combo.c
+    OPT_DEFS += -DCOMBO_ENABLE
+endif
+
+ifdef HID_COMMAND_ENABLE
+    SRC += $(COMMON_DIR)/hid_command.c
+    OPT_DEFS += -DHID_COMMAND_ENABLE
+endif
+
 ifdef NKRO_ENABLE
     OPT_DEFS += -DNKRO_ENABLE
 endif
@@ -53,6 +88,14 @@ ifdef USB_6KRO_ENABLE
     OPT_DEFS += -DUSB_6KRO_ENABLE
 endif
 
+ifdef HYBRID_KRO_ENABLE
+    OPT_DEFS += -DHYBRID_KRO_ENABLE
+endif
+
+ifdef USB_LOW_LATENCY_ENABLE
+    OPT_DEFS += -DUSB_LOW_LATENCY_ENABLE
+endif
+
 ifdef SLEEP_LED_ENABLE
     SRC += $(COMMON_DIR)/sleep_led.c
     OPT_DEFS += -DSLEEP_LED_ENABLE
@@ -64,6 +107,28 @@ ifdef BACKLIGHT_ENABLE
     OPT_DEFS += -DBACKLIGHT_ENABLE
 endif
 
+ifdef INDICATOR_ENABLE
+    SRC += $(COMMON_DIR)/indicator.c
+    OPT_DEFS += -DINDICATOR_ENABLE
+endif
+
+ifdef ACTIONMAP_ENABLE
+    OPT_DEFS += -DACTIONMAP_ENABLE
+endif
+
+ifdef KEYMAP_SPARSE_ENABLE
+    OPT_DEFS += -DKEYMAP_SPARSE_ENABLE
+endif
+
+ifneq (,$(ACTIONMAP_ENABLE)$(KEYMAP_SPARSE_ENABLE))
+    SRC += actionmap.c
+endif
+
+ifdef KEYMAP_OVERLAY_ENABLE
+    SRC += $(COMMON_DIR)/keymap_overlay.c
+    OPT_DEFS += -DKEYMAP_OVERLAY_ENABLE
+endif
+
 ifdef KEYMAP_SECTION_ENABLE
     OPT_DEFS += -DKEYMAP_SECTION_ENABLE
     EXTRALDFLAGS = -Wl,-L$(TOP_DIR),-Tldscript_keymap_avr5.x
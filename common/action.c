@@ -26,6 +26,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_macro.h"
 #include "action_util.h"
 #include "action.h"
+#ifdef STENO_ENABLE
+#include "steno.h"
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#include "dynamic_macro.h"
+#endif
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -202,6 +208,11 @@ void process_action(keyrecord_t *record)
             }
             break;
 #endif
+#ifdef STENO_ENABLE
+        case ACT_STENO:
+            steno_key(action.key.code, event.pressed);
+            break;
+#endif
 #ifndef NO_ACTION_LAYER
         case ACT_LAYER:
             if (action.layer_bitop.on == 0) {
@@ -298,6 +309,18 @@ void process_action(keyrecord_t *record)
         /* Extentions */
 #ifndef NO_ACTION_MACRO
         case ACT_MACRO:
+#ifdef DYNAMIC_MACRO_ENABLE
+            if (action.func.opt == MACRO_DYNAMIC) {
+                if (event.pressed) {
+                    if (action.func.id & MACRO_DYNAMIC_PLAY) {
+                        dynamic_macro_play(action.func.id & ~MACRO_DYNAMIC_PLAY);
+                    } else {
+                        dynamic_macro_record(action.func.id);
+                    }
+                }
+                break;
+            }
+#endif
             action_macro_play(action_get_macro(record, action.func.id, action.func.opt));
             break;
 #endif
@@ -520,6 +543,8 @@ bool is_tap_key(keypos_t key)
         case ACT_LAYER_TAP_EXT:
             return true;
         case ACT_MACRO:
+            if (action.func.opt == MACRO_DYNAMIC) { return false; }
+            /* fall through */
         case ACT_FUNCTION:
             if (action.func.opt & FUNC_TAP) { return true; }
             return false;
@@ -553,6 +578,7 @@ void debug_action(action_t action)
         case ACT_RMODS_TAP:         dprint("ACT_RMODS_TAP");         break;
         case ACT_USAGE:             dprint("ACT_USAGE");             break;
         case ACT_MOUSEKEY:          dprint("ACT_MOUSEKEY");          break;
+        case ACT_STENO:             dprint("ACT_STENO");             break;
         case ACT_LAYER:             dprint("ACT_LAYER");             break;
         case ACT_LAYER_TAP:         dprint("ACT_LAYER_TAP");         break;
         case ACT_LAYER_TAP_EXT:     dprint("ACT_LAYER_TAP_EXT");     break;
@@ -50,7 +50,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * ACT_MOUSEKEY(0110): TODO: Not needed?
  * 0101|xxxx| keycode     Mouse key
  *
- * 011x|xxxx xxxx xxxx    (reseved)
+ * 0110|0000| keycode     Deferred Fn key(actionmap only, see keymap.h)
+ * 0110|xxxx xxxx xxxx    (reseved)
+ *
+ * ACT_STENO(0111):
+ * 0111|0000|000b bbbb    Steno key, bit 0-31 of chord(see steno.h)
  *
  *
  * Layer Actions(10xx)
@@ -84,7 +88,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
  * ----------------
  * ACT_MACRO(1100):
  * 1100|opt | id(8)      Macro play?
- * 1100|1111| id(8)      Macro record?
+ * 1100|1111|0 id(7)     Dynamic macro record start/stop(see dynamic_macro.h)
+ * 1100|1111|1 id(7)     Dynamic macro play
  *
  * ACT_BACKLIGHT(1101):
  * 1101|opt |level(8)    Backlight commands
@@ -107,6 +112,7 @@ enum action_kind_id {
     /* Other Keys */
     ACT_USAGE           = 0b0100,
     ACT_MOUSEKEY        = 0b0101,
+    ACT_STENO           = 0b0111,
     /* Layer Actions */
     ACT_LAYER           = 0b1000,
     ACT_LAYER_TAP       = 0b1010, /* Layer  0-15 */
@@ -228,6 +234,7 @@ enum usage_pages {
 #define ACTION_USAGE_SYSTEM(id)         ACTION(ACT_USAGE, PAGE_SYSTEM<<10 | (id))
 #define ACTION_USAGE_CONSUMER(id)       ACTION(ACT_USAGE, PAGE_CONSUMER<<10 | (id))
 #define ACTION_MOUSEKEY(key)            ACTION(ACT_MOUSEKEY, key)
+#define ACTION_STENO(bit)               ACTION(ACT_STENO, (bit)&0x1f)
 
 
 
@@ -293,9 +300,15 @@ enum backlight_opt {
     BACKLIGHT_LEVEL    = 4,
 };
 /* Macro */
+enum macro_opts {
+    MACRO_DYNAMIC = 0xF,
+};
+#define MACRO_DYNAMIC_PLAY  0x80    /* in id: play instead of record */
 #define ACTION_MACRO(id)                ACTION(ACT_MACRO, (id))
 #define ACTION_MACRO_TAP(id)            ACTION(ACT_MACRO, FUNC_TAP<<8 | (id))
 #define ACTION_MACRO_OPT(id, opt)       ACTION(ACT_MACRO, (opt)<<8 | (id))
+#define ACTION_MACRO_PLAY(id)           ACTION(ACT_MACRO, MACRO_DYNAMIC<<8 | MACRO_DYNAMIC_PLAY | (id))
+#define ACTION_MACRO_RECORD(id)         ACTION(ACT_MACRO, MACRO_DYNAMIC<<8 | (id))
 /* Backlight */
 #define ACTION_BACKLIGHT_INCREASE()     ACTION(ACT_BACKLIGHT, BACKLIGHT_INCREASE << 8)
 #define ACTION_BACKLIGHT_DECREASE()     ACTION(ACT_BACKLIGHT, BACKLIGHT_DECREASE << 8)
@@ -3,6 +3,14 @@
 #include "action.h"
 #include "util.h"
 #include "action_layer.h"
+#include "keymap.h"
+#include "indicator.h"
+#ifdef COMBO_ENABLE
+#include "combo.h"
+#endif
+#ifdef KEYMAP_OVERLAY_ENABLE
+#include "keymap_overlay.h"
+#endif
 
 #ifdef DEBUG_ACTION
 #include "debug.h"
@@ -20,7 +28,10 @@ static void default_layer_state_set(uint32_t state)
 {
     debug("default_layer_state: ");
     default_layer_debug(); debug(" to ");
-    default_layer_state = state;
+    if (default_layer_state != state) {
+        default_layer_state = state;
+        indicator_layer_changed();
+    }
     default_layer_debug(); debug("\n");
     clear_keyboard_but_mods(); // To avoid stuck keys
 }
@@ -61,7 +72,10 @@ static void layer_state_set(uint32_t state)
 {
     dprint("layer_state: ");
     layer_debug(); dprint(" to ");
-    layer_state = state;
+    if (layer_state != state) {
+        layer_state = state;
+        indicator_layer_changed();
+    }
     layer_debug(); dprintln();
     clear_keyboard_but_mods(); // To avoid stuck keys
 }
@@ -117,8 +131,29 @@ action_t layer_switch_get_action(keypos_t key)
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
+#ifdef COMBO_ENABLE
+    /* virtual key of combo has action in combo table, not in keymap */
+    if (IS_COMBO_KEY(key)) return combo_get_action(key);
+#endif
+
 #ifndef NO_ACTION_LAYER
     uint32_t layers = layer_state | default_layer_state;
+#ifdef KEYMAP_SPARSE_ENABLE
+    /* go straight to active layers which define the key, top layer first */
+#ifdef KEYMAP_OVERLAY_ENABLE
+    layers &= keymap_layers_for_key(key) | keymap_overlay_layers(key);
+#else
+    layers &= keymap_layers_for_key(key);
+#endif
+    while (layers) {
+        uint8_t i = biton32(layers);
+        action = action_for_key(i, key);
+        if (action.code != ACTION_TRANSPARENT) {
+            return action;
+        }
+        layers &= ~(1UL<<i);
+    }
+#else
     /* check top layer first */
     for (int8_t i = 31; i >= 0; i--) {
         if (layers & (1UL<<i)) {
@@ -128,6 +163,7 @@ action_t layer_switch_get_action(keypos_t key)
             }
         }
     }
+#endif
     /* fall back to layer 0 */
     action = action_for_key(0, key);
     return action;
@@ -18,16 +18,31 @@
 #define IS_TAPPING_PRESSED()    (IS_TAPPING() && tapping_key.event.pressed)
 #define IS_TAPPING_RELEASED()   (IS_TAPPING() && !tapping_key.event.pressed)
 #define IS_TAPPING_KEY(k)       (IS_TAPPING() && KEYEQ(tapping_key.event.key, (k)))
-#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < TAPPING_TERM)
+#define WITHIN_TAPPING_TERM(e)  (TIMER_DIFF_16(e.time, tapping_key.event.time) < get_tapping_term(tapping_key.event))
+
+/* next index of waiting_buffer ring without division */
+#define WAITING_BUFFER_NEXT(i)  ((uint8_t)((i) + 1) < WAITING_BUFFER_SIZE ? (uint8_t)((i) + 1) : 0)
+
+/* legacy: long TAPPING_TERM implies permissive hold */
+#if TAPPING_TERM >= 500 && !defined(PERMISSIVE_HOLD)
+#define PERMISSIVE_HOLD
+#endif
 
 
 static keyrecord_t tapping_key = {};
+#ifdef RETRO_TAPPING
+/* tap key held over tapping term without other key */
+static keypos_t retro_key;
+static bool retro_tapping = false;
+#endif
 static keyrecord_t waiting_buffer[WAITING_BUFFER_SIZE] = {};
 static uint8_t waiting_buffer_head = 0;
 static uint8_t waiting_buffer_tail = 0;
 
 static bool process_tapping(keyrecord_t *record);
 static bool waiting_buffer_enq(keyrecord_t record);
+static void waiting_buffer_process(void);
+static void waiting_buffer_settle_hold(void);
 static void waiting_buffer_clear(void);
 static bool waiting_buffer_typed(keyevent_t event);
 static bool waiting_buffer_has_anykey_pressed(void);
@@ -35,6 +50,34 @@ static void waiting_buffer_scan_tap(void);
 static void debug_tapping_key(void);
 static void debug_waiting_buffer(void);
 
+#if defined(HOLD_ON_OTHER_KEY_PRESS) || defined(MODS_TAP_HOLD_ON_OTHER_KEY_PRESS)
+/* whether tapping key is decided as hold when other key is pressed */
+static bool hold_on_other_key_press(void)
+{
+#ifdef HOLD_ON_OTHER_KEY_PRESS
+    return true;
+#else
+    // dual-role modifier only, not oneshot and tap toggle
+    action_t action = layer_switch_get_action(tapping_key.event.key);
+    switch (action.kind.id) {
+        case ACT_LMODS_TAP:
+        case ACT_RMODS_TAP:
+            return action.key.mods && action.key.code != MODS_ONESHOT &&
+                                      action.key.code != MODS_TAP_TOGGLE;
+        default:
+            return false;
+    }
+#endif
+}
+#endif
+
+
+/* override to set tapping term per key or action */
+__attribute__ ((weak))
+uint16_t get_tapping_term(keyevent_t event)
+{
+    return TAPPING_TERM;
+}
 
 void action_tapping_process(keyrecord_t record)
 {
@@ -44,11 +87,16 @@ void action_tapping_process(keyrecord_t record)
         }
     } else {
         if (!waiting_buffer_enq(record)) {
-            // clear all in case of overflow.
-            debug("OVERFLOW: CLEAR ALL STATES\n");
-            clear_keyboard();
-            waiting_buffer_clear();
-            tapping_key = (keyrecord_t){};
+            // settle tapping key as hold to make room
+            debug("OVERFLOW: SETTLE TAPPING KEY AS HOLD\n");
+            waiting_buffer_settle_hold();
+            if (!waiting_buffer_enq(record)) {
+                // clear all in case of overflow.
+                debug("OVERFLOW: CLEAR ALL STATES\n");
+                clear_keyboard();
+                waiting_buffer_clear();
+                tapping_key = (keyrecord_t){};
+            }
         }
     }
 
@@ -56,14 +104,7 @@ void action_tapping_process(keyrecord_t record)
     if (!IS_NOEVENT(record.event) && waiting_buffer_head != waiting_buffer_tail) {
         debug("---- action_exec: process waiting_buffer -----\n");
     }
-    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = (waiting_buffer_tail + 1) % WAITING_BUFFER_SIZE) {
-        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
-            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
-            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
-        } else {
-            break;
-        }
-    }
+    waiting_buffer_process();
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
@@ -74,6 +115,15 @@ void action_tapping_process(keyrecord_t record)
  *
  * Rule: Tap key is typed(pressed and released) within TAPPING_TERM.
  *       (without interfering by typing other key)
+ *
+ * Hold can be decided before TAPPING_TERM with these options in config.h:
+ *   PERMISSIVE_HOLD            other key is typed(pressed and released)
+ *   HOLD_ON_OTHER_KEY_PRESS    other key is pressed
+ *   MODS_TAP_HOLD_ON_OTHER_KEY_PRESS
+ *                              other key is pressed while dual-role modifier
+ *                              is undecided
+ * And with RETRO_TAPPING tap key held over TAPPING_TERM without other key
+ * sends its tap after hold on release.
  */
 /* return true when key event is processed or consumed. */
 bool process_tapping(keyrecord_t *keyp)
@@ -96,7 +146,7 @@ bool process_tapping(keyrecord_t *keyp)
                     // enqueue
                     return false;
                 }
-#if TAPPING_TERM >= 500
+#ifdef PERMISSIVE_HOLD
                 /* Process a key typed within TAPPING_TERM
                  * This can register the key before settlement of tapping,
                  * useful for long TAPPING_TERM but may prevent fast typing.
@@ -109,6 +159,22 @@ bool process_tapping(keyrecord_t *keyp)
                     // enqueue
                     return false;
                 }
+#endif
+#if defined(HOLD_ON_OTHER_KEY_PRESS) || defined(MODS_TAP_HOLD_ON_OTHER_KEY_PRESS)
+                /* Other key pressed: hold without waiting for TAPPING_TERM */
+                else if (IS_PRESSED(event) && hold_on_other_key_press()) {
+                    debug("Tapping: End. No tap. Other key pressed\n");
+                    process_action(&tapping_key);
+                    tapping_key = (keyrecord_t){};
+                    debug_tapping_key();
+                    // nothing waits before this key; process it now unless it starts tapping
+                    if (waiting_buffer_head == waiting_buffer_tail && !is_tap_key(event.key)) {
+                        process_action(keyp);
+                        return true;
+                    }
+                    // enqueue
+                    return false;
+                }
 #endif
                 /* Process release event of a key pressed before tapping starts
                  * Without this unexpected repeating will occur with having fast repeating setting
@@ -185,6 +251,10 @@ bool process_tapping(keyrecord_t *keyp)
             if (tapping_key.tap.count == 0) {
                 debug("Tapping: End. Timeout. Not tap(0): ");
                 debug_event(event); debug("\n");
+#ifdef RETRO_TAPPING
+                retro_tapping = !tapping_key.tap.interrupted;
+                retro_key = tapping_key.event.key;
+#endif
                 process_action(&tapping_key);
                 tapping_key = (keyrecord_t){};
                 debug_tapping_key();
@@ -273,6 +343,21 @@ bool process_tapping(keyrecord_t *keyp)
     }
     // not tapping state
     else {
+#ifdef RETRO_TAPPING
+        if (IS_PRESSED(event)) {
+            retro_tapping = false;
+        } else if (retro_tapping && IS_RELEASED(event) && KEYEQ(event.key, retro_key)) {
+            debug("Tapping: Retro tap.\n");
+            retro_tapping = false;
+            process_action(keyp);
+            keyrecord_t tap = { .event = event, .tap.count = 1 };
+            tap.event.pressed = true;
+            process_action(&tap);
+            tap.event.pressed = false;
+            process_action(&tap);
+            return true;
+        }
+#endif
         if (event.pressed && is_tap_key(event.key)) {
             debug("Tapping: Start(Press tap key).\n");
             tapping_key = *keyp;
@@ -296,18 +381,45 @@ bool waiting_buffer_enq(keyrecord_t record)
         return true;
     }
 
-    if ((waiting_buffer_head + 1) % WAITING_BUFFER_SIZE == waiting_buffer_tail) {
+    if (WAITING_BUFFER_NEXT(waiting_buffer_head) == waiting_buffer_tail) {
         debug("waiting_buffer_enq: Over flow.\n");
         return false;
     }
 
     waiting_buffer[waiting_buffer_head] = record;
-    waiting_buffer_head = (waiting_buffer_head + 1) % WAITING_BUFFER_SIZE;
+    waiting_buffer_head = WAITING_BUFFER_NEXT(waiting_buffer_head);
 
     debug("waiting_buffer_enq: "); debug_waiting_buffer();
     return true;
 }
 
+/* processes events in order until one has to wait for tapping */
+void waiting_buffer_process(void)
+{
+    for (; waiting_buffer_tail != waiting_buffer_head; waiting_buffer_tail = WAITING_BUFFER_NEXT(waiting_buffer_tail)) {
+        if (process_tapping(&waiting_buffer[waiting_buffer_tail])) {
+            debug("processed: waiting_buffer["); debug_dec(waiting_buffer_tail); debug("] = ");
+            debug_record(waiting_buffer[waiting_buffer_tail]); debug("\n\n");
+        } else {
+            break;
+        }
+    }
+}
+
+/*
+ * Buffer is full only while tapping key is undecided. Deciding it as hold
+ * lets the buffered events go through in order, as if TAPPING_TERM had passed.
+ */
+void waiting_buffer_settle_hold(void)
+{
+    if (IS_TAPPING_PRESSED() && tapping_key.tap.count == 0) {
+        process_action(&tapping_key);
+    }
+    tapping_key = (keyrecord_t){};
+    debug_tapping_key();
+    waiting_buffer_process();
+}
+
 void waiting_buffer_clear(void)
 {
     waiting_buffer_head = 0;
@@ -316,7 +428,7 @@ void waiting_buffer_clear(void)
 
 bool waiting_buffer_typed(keyevent_t event)
 {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (KEYEQ(event.key, waiting_buffer[i].event.key) && event.pressed !=  waiting_buffer[i].event.pressed) {
             return true;
         }
@@ -326,7 +438,7 @@ bool waiting_buffer_typed(keyevent_t event)
 
 bool waiting_buffer_has_anykey_pressed(void)
 {
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (waiting_buffer[i].event.pressed) return true;
     }
     return false;
@@ -340,7 +452,7 @@ void waiting_buffer_scan_tap(void)
     // invalid state: tapping_key released && tap.count == 0
     if (!tapping_key.event.pressed) return;
 
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         if (IS_TAPPING_KEY(waiting_buffer[i].event.key) &&
                 !waiting_buffer[i].event.pressed &&
                 WITHIN_TAPPING_TERM(waiting_buffer[i].event)) {
@@ -367,7 +479,7 @@ static void debug_tapping_key(void)
 static void debug_waiting_buffer(void)
 {
     debug("{ ");
-    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = (i + 1) % WAITING_BUFFER_SIZE) {
+    for (uint8_t i = waiting_buffer_tail; i != waiting_buffer_head; i = WAITING_BUFFER_NEXT(i)) {
         debug("["); debug_dec(i); debug("]="); debug_record(waiting_buffer[i]); debug(" ");
     }
     debug("}\n");
@@ -29,11 +29,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define TAPPING_TOGGLE  5
 #endif
 
-#define WAITING_BUFFER_SIZE 8
+/* events held while tap key is undecided */
+#ifndef WAITING_BUFFER_SIZE
+#define WAITING_BUFFER_SIZE 16
+#endif
 
 
 #ifndef NO_ACTION_TAPPING
 void action_tapping_process(keyrecord_t record);
+/* tapping term(ms) of key; TAPPING_TERM unless keymap defines this */
+uint16_t get_tapping_term(keyevent_t event);
 #endif
 
 #endif
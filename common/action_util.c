@@ -19,27 +19,49 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "debug.h"
 #include "action_util.h"
 #include "timer.h"
+#ifdef KEY_REPEAT_ENABLE
+#include "key_repeat.h"
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#include "dynamic_macro.h"
+#endif
 
-static inline void add_key_byte(uint8_t code);
+static inline bool add_key_byte(uint8_t code);
 static inline void del_key_byte(uint8_t code);
 #ifdef NKRO_ENABLE
-static inline void add_key_bit(uint8_t code);
+static inline bool add_key_bit(uint8_t code);
 static inline void del_key_bit(uint8_t code);
 #endif
+#ifdef HYBRID_KRO_ENABLE
+static inline bool add_key_hybrid(uint8_t code);
+static inline void del_key_hybrid(uint8_t code);
+#endif
 
 static uint8_t real_mods = 0;
 static uint8_t weak_mods = 0;
 
-#ifdef USB_6KRO_ENABLE
-#define RO_ADD(a, b) ((a + b) % KEYBOARD_REPORT_KEYS)
-#define RO_SUB(a, b) ((a - b + KEYBOARD_REPORT_KEYS) % KEYBOARD_REPORT_KEYS)
-#define RO_INC(a) RO_ADD(a, 1)
-#define RO_DEC(a) RO_SUB(a, 1)
-static int8_t cb_head = 0;
-static int8_t cb_tail = 0;
-static int8_t cb_count = 0;
+/* Pressed keys in report
+ *
+ * Count and bitmap of keys are kept along with report so that queries don't
+ * need to scan it. Keys in 6KRO report are a ring in order of press, oldest
+ * at key_head, so that roll over replaces the oldest key in place; NKRO report
+ * keeps the order in key_order separately.
+ */
+static uint8_t key_count = 0;
+static uint8_t key_head = 0;
+static uint8_t key_bits[32];
+#ifdef NKRO_ENABLE
+static uint8_t key_order[KEYBOARD_REPORT_KEYS];
+static uint8_t key_order_count = 0;
 #endif
 
+#define KEY_BIT_IS_ON(code)     (key_bits[(code)>>3] & (1<<((code)&7)))
+#define KEY_BIT_ON(code)        (key_bits[(code)>>3] |= (1<<((code)&7)))
+#define KEY_BIT_OFF(code)       (key_bits[(code)>>3] &= ~(1<<((code)&7)))
+
+/* slot of report keys 'i' slots after slot 'head'(i <= KEYBOARD_REPORT_KEYS) */
+#define KEY_SLOT(head, i)       ((head) + (i) < KEYBOARD_REPORT_KEYS ? (head) + (i) : (head) + (i) - KEYBOARD_REPORT_KEYS)
+
 // TODO: pointer variable is not needed
 //report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
@@ -68,6 +90,9 @@ void send_keyboard_report(void) {
             clear_oneshot_mods();
         }
     }
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_mods(keyboard_report->mods);
 #endif
     host_keyboard_send(keyboard_report);
 }
@@ -75,24 +100,48 @@ void send_keyboard_report(void) {
 /* key */
 void add_key(uint8_t key)
 {
+    if (KEY_BIT_IS_ON(key)) return;
 #ifdef NKRO_ENABLE
     if (keyboard_nkro) {
-        add_key_bit(key);
-        return;
-    }
+        if (!add_key_bit(key)) return;
+    } else
+#endif
+#ifdef HYBRID_KRO_ENABLE
+    if (!add_key_hybrid(key)) return;
+#else
+    if (!add_key_byte(key)) return;
+#endif
+    KEY_BIT_ON(key);
+    key_count++;
+#ifdef KEY_REPEAT_ENABLE
+    key_repeat_press(key);
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_key(key, true);
 #endif
-    add_key_byte(key);
 }
 
 void del_key(uint8_t key)
 {
+    if (!KEY_BIT_IS_ON(key)) return;
 #ifdef NKRO_ENABLE
     if (keyboard_nkro) {
         del_key_bit(key);
-        return;
-    }
+    } else
 #endif
+#ifdef HYBRID_KRO_ENABLE
+    del_key_hybrid(key);
+#else
     del_key_byte(key);
+#endif
+    KEY_BIT_OFF(key);
+    key_count--;
+#ifdef KEY_REPEAT_ENABLE
+    key_repeat_release(key);
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_key(key, false);
+#endif
 }
 
 void clear_keys(void)
@@ -101,6 +150,17 @@ void clear_keys(void)
     for (int8_t i = 1; i < KEYBOARD_REPORT_SIZE; i++) {
         keyboard_report->raw[i] = 0;
     }
+    for (uint8_t i = 0; i < sizeof(key_bits); i++) {
+        key_bits[i] = 0;
+    }
+    key_count = 0;
+    key_head = 0;
+#ifdef NKRO_ENABLE
+    key_order_count = 0;
+#endif
+#ifdef KEY_REPEAT_ENABLE
+    key_repeat_clear();
+#endif
 }
 
 
@@ -144,12 +204,7 @@ void clear_oneshot_mods(void)
  */
 uint8_t has_anykey(void)
 {
-    uint8_t cnt = 0;
-    for (uint8_t i = 1; i < KEYBOARD_REPORT_SIZE; i++) {
-        if (keyboard_report->raw[i])
-            cnt++;
-    }
-    return cnt;
+    return key_count;
 }
 
 uint8_t has_anymod(void)
@@ -159,149 +214,150 @@ uint8_t has_anymod(void)
 
 uint8_t get_first_key(void)
 {
+    if (!key_count) return 0;
 #ifdef NKRO_ENABLE
     if (keyboard_nkro) {
+        if (key_order_count) {
+            return key_order[0];
+        }
+        /* keys held longer have overflowed key_order and been released */
         uint8_t i = 0;
         for (; i < KEYBOARD_REPORT_BITS && !keyboard_report->nkro.bits[i]; i++)
             ;
         return i<<3 | biton(keyboard_report->nkro.bits[i]);
     }
 #endif
-#ifdef USB_6KRO_ENABLE
-    uint8_t i = cb_head;
-    do {
-        if (keyboard_report->keys[i] != 0) {
-            break;
-        }
-        i = RO_INC(i);
-    } while (i != cb_tail);
-    return keyboard_report->keys[i];
-#else
-    return keyboard_report->keys[0];
-#endif
+    return keyboard_report->keys[key_head];
 }
 
 
 
 /* local functions */
-static inline void add_key_byte(uint8_t code)
+
+/* removes entry at 'i' from packed list of 'count' keys */
+static inline void remove_packed(uint8_t *keys, uint8_t count, uint8_t i)
 {
-#ifdef USB_6KRO_ENABLE
-    int8_t i = cb_head;
-    int8_t empty = -1;
-    if (cb_count) {
-        do {
-            if (keyboard_report->keys[i] == code) {
-                return;
-            }
-            if (empty == -1 && keyboard_report->keys[i] == 0) {
-                empty = i;
-            }
-            i = RO_INC(i);
-        } while (i != cb_tail);
-        if (i == cb_tail) {
-            if (cb_tail == cb_head) {
-                // buffer is full
-                if (empty == -1) {
-                    // pop head when has no empty space
-                    cb_head = RO_INC(cb_head);
-                    cb_count--;
-                }
-                else {
-                    // left shift when has empty space
-                    uint8_t offset = 1;
-                    i = RO_INC(empty);
-                    do {
-                        if (keyboard_report->keys[i] != 0) {
-                            keyboard_report->keys[empty] = keyboard_report->keys[i];
-                            keyboard_report->keys[i] = 0;
-                            empty = RO_INC(empty);
-                        }
-                        else {
-                            offset++;
-                        }
-                        i = RO_INC(i);
-                    } while (i != cb_tail);
-                    cb_tail = RO_SUB(cb_tail, offset);
-                }
-            }
-        }
+    for (; i < count - 1; i++) {
+        keys[i] = keys[i + 1];
     }
-    // add to tail
-    keyboard_report->keys[cb_tail] = code;
-    cb_tail = RO_INC(cb_tail);
-    cb_count++;
+    keys[i] = 0;
+}
+
+static inline bool add_key_byte(uint8_t code)
+{
+    if (key_count == KEYBOARD_REPORT_KEYS) {
+#ifdef USB_6KRO_ENABLE
+        // roll over: oldest key is replaced with new one, which becomes newest
+        KEY_BIT_OFF(keyboard_report->keys[key_head]);
+        key_count--;
+        keyboard_report->keys[key_head] = code;
+        key_head = KEY_SLOT(key_head, 1);
+        return true;
 #else
-    int8_t i = 0;
-    int8_t empty = -1;
-    for (; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            break;
-        }
-        if (empty == -1 && keyboard_report->keys[i] == 0) {
-            empty = i;
-        }
-    }
-    if (i == KEYBOARD_REPORT_KEYS) {
-        if (empty != -1) {
-            keyboard_report->keys[empty] = code;
-        }
-    }
+        return false;
 #endif
+    }
+    keyboard_report->keys[KEY_SLOT(key_head, key_count)] = code;
+    return true;
 }
 
 static inline void del_key_byte(uint8_t code)
 {
-#ifdef USB_6KRO_ENABLE
-    uint8_t i = cb_head;
-    if (cb_count) {
-        do {
-            if (keyboard_report->keys[i] == code) {
-                keyboard_report->keys[i] = 0;
-                cb_count--;
-                if (cb_count == 0) {
-                    // reset head and tail
-                    cb_tail = cb_head = 0;
-                }
-                if (i == RO_DEC(cb_tail)) {
-                    // left shift when next to tail
-                    do {
-                        cb_tail = RO_DEC(cb_tail);
-                        if (keyboard_report->keys[RO_DEC(cb_tail)] != 0) {
-                            break;
-                        }
-                    } while (cb_tail != cb_head);
-                }
-                break;
-            }
-            i = RO_INC(i);
-        } while (i != cb_tail);
+    uint8_t i = key_head;
+    if (keyboard_report->keys[i] == code) {
+        // oldest key: ring just starts at next
+        keyboard_report->keys[i] = 0;
+        key_head = KEY_SLOT(i, 1);
+        return;
     }
-#else
-    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
-        if (keyboard_report->keys[i] == code) {
-            keyboard_report->keys[i] = 0;
+    for (uint8_t n = 1; n < key_count; n++) {
+        i = KEY_SLOT(i, 1);
+        if (keyboard_report->keys[i] != code) continue;
+
+        // close the gap with newer keys
+        for (n++; n < key_count; n++) {
+            uint8_t next = KEY_SLOT(i, 1);
+            keyboard_report->keys[i] = keyboard_report->keys[next];
+            i = next;
         }
+        keyboard_report->keys[i] = 0;
+        return;
     }
-#endif
 }
 
 #ifdef NKRO_ENABLE
-static inline void add_key_bit(uint8_t code)
+static inline bool add_key_bit(uint8_t code)
 {
     if ((code>>3) < KEYBOARD_REPORT_BITS) {
         keyboard_report->nkro.bits[code>>3] |= 1<<(code&7);
     } else {
         dprintf("add_key_bit: can't add: %02X\n", code);
+        return false;
     }
+    if (key_order_count < KEYBOARD_REPORT_KEYS) {
+        key_order[key_order_count++] = code;
+    }
+    return true;
 }
 
 static inline void del_key_bit(uint8_t code)
 {
-    if ((code>>3) < KEYBOARD_REPORT_BITS) {
-        keyboard_report->nkro.bits[code>>3] &= ~(1<<(code&7));
-    } else {
-        dprintf("del_key_bit: can't del: %02X\n", code);
+    keyboard_report->nkro.bits[code>>3] &= ~(1<<(code&7));
+    for (uint8_t i = 0; i < key_order_count; i++) {
+        if (key_order[i] == code) {
+            remove_packed(key_order, key_order_count--, i);
+            return;
+        }
+    }
+}
+#endif
+
+#ifdef HYBRID_KRO_ENABLE
+/*
+ * keys[] holds the oldest keys up to KEYBOARD_REPORT_KEYS for boot report and
+ * bitmap holds all of them. Keys beyond keys[] are dropped unless the driver
+ * can send the bitmap.
+ */
+static inline bool add_key_hybrid(uint8_t code)
+{
+    if ((code>>3) >= KEYBOARD_REPORT_BITS) {
+        dprintf("add_key_hybrid: can't add: %02X\n", code);
+        return false;
+    }
+    if (key_count < KEYBOARD_REPORT_KEYS) {
+        keyboard_report->keys[key_count] = code;
+    } else if (!(host_keyboard_caps() & HOST_KEYBOARD_HYBRID)) {
+        return false;
+    }
+    keyboard_report->hybrid.bits[code>>3] |= 1<<(code&7);
+    return true;
+}
+
+static inline void del_key_hybrid(uint8_t code)
+{
+    keyboard_report->hybrid.bits[code>>3] &= ~(1<<(code&7));
+
+    uint8_t n = (key_count < KEYBOARD_REPORT_KEYS ? key_count : KEYBOARD_REPORT_KEYS);
+    uint8_t i = 0;
+    for (; i < n && keyboard_report->keys[i] != code; i++)
+        ;
+    if (i == n) return;
+    remove_packed(keyboard_report->keys, n, i);
+    if (key_count <= KEYBOARD_REPORT_KEYS) return;
+
+    /* refill keys[] with a key held only in bitmap */
+    for (uint8_t j = 0; j < KEYBOARD_REPORT_BITS; j++) {
+        uint8_t bits = keyboard_report->hybrid.bits[j];
+        for (uint8_t k = 0; bits; k++, bits >>= 1) {
+            if (!(bits & 1)) continue;
+            uint8_t c = j<<3 | k;
+            for (i = 0; i < KEYBOARD_REPORT_KEYS - 1 && keyboard_report->keys[i] != c; i++)
+                ;
+            if (i == KEYBOARD_REPORT_KEYS - 1) {
+                keyboard_report->keys[i] = c;
+                return;
+            }
+        }
     }
 }
 #endif
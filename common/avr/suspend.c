@@ -3,6 +3,7 @@
 #include <avr/wdt.h>
 #include <avr/interrupt.h>
 #include "matrix.h"
+#include "keyboard.h"
 #include "action.h"
 #include "backlight.h"
 #include "suspend_avr.h"
@@ -80,32 +81,110 @@ static void power_down(uint8_t wdto)
     wdt_disable();
 }
 
+/*
+ * Matrix interrupt wake
+ * When matrix supports matrix_wakeup_enable() a key press wakes MCU at once
+ * with pin change interrupt and watchdog slices don't scan matrix at all.
+ * Otherwise matrix is scanned every 15ms slice.
+ */
+#ifndef SUSPEND_WAKEUP_SCAN_TIME
+#define SUSPEND_WAKEUP_SCAN_TIME    20  /* ms to wait for debounce after pin change */
+#endif
+#ifndef SUSPEND_WAKEUP_TIMEOUT
+#define SUSPEND_WAKEUP_TIMEOUT      100 /* ms to wait for host to resume */
+#endif
+static bool wakeup_armed = false;
+static volatile bool wakeup_event = false;
+/* remote wakeup is requested and waiting for host to resume */
+static bool wakeup_pending = false;
+static uint16_t wakeup_time = 0;
+static uint16_t wakeup_latency = 0;
+
+static void wakeup_disarm(void)
+{
+    if (wakeup_armed) {
+        matrix_wakeup_disable();
+        wakeup_armed = false;
+    }
+}
+
 void suspend_power_down(void)
 {
+    // don't sleep until host resumes, or wakeup latency gets 15ms slices
+    if (wakeup_pending) {
+        if (timer_elapsed(wakeup_time) < SUSPEND_WAKEUP_TIMEOUT) return;
+        // host ignored remote wakeup: keys to wake it up are stale by next resume
+        wakeup_pending = false;
+        keyboard_wakeup_clear();
+    }
+
+    if (!wakeup_armed) {
+        wakeup_event = false;
+        wakeup_armed = matrix_wakeup_enable();
+    }
     power_down(WDTO_15MS);
 }
 
+/* called from pin change interrupt of matrix */
+void suspend_wakeup_event(void)
+{
+    wakeup_event = true;
+}
+
 bool suspend_wakeup_condition(void)
 {
+    if (wakeup_pending) return false;
+
+    bool settle = false;
+    if (wakeup_armed) {
+        if (!wakeup_event) return false;
+        wakeup_disarm();
+        // scan until debounce settles rather than one scan per slice
+        settle = true;
+    }
+    wakeup_time = timer_read();
+
     matrix_power_up();
-    matrix_scan();
+    do {
+        matrix_scan();
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            if (matrix_get_row(r)) goto WAKEUP;
+        }
+    } while (settle && timer_elapsed(wakeup_time) < SUSPEND_WAKEUP_SCAN_TIME);
     matrix_power_down();
-    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-        if (matrix_get_row(r)) return true;
-    }
+    // wakeup by bounce or release
     return false;
+
+WAKEUP:
+    matrix_power_down();
+    // keep keys pressed to wake host up even if released before resume
+    keyboard_wakeup_keys();
+    wakeup_pending = true;
+    return true;
 }
 
 // run immediately after wakeup
 void suspend_wakeup_init(void)
 {
-    // clear keyboard state
+    wakeup_disarm();
+    if (wakeup_pending) {
+        wakeup_latency = timer_elapsed(wakeup_time);
+        wakeup_pending = false;
+    }
+
+    // clear keyboard state, keys to wake up are processed after this
     clear_keyboard();
 #ifdef BACKLIGHT_ENABLE
-    backlight_init();
+    backlight_restore();
 #endif
 }
 
+/* time(ms) from wakeup key to host resume of last remote wakeup */
+uint16_t suspend_wakeup_latency(void)
+{
+    return wakeup_latency;
+}
+
 #ifndef NO_SUSPEND_POWER_DOWN
 /* watchdog timeout */
 ISR(WDT_vect)
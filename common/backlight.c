@@ -31,6 +31,12 @@ void backlight_init(void)
     backlight_set(backlight_config.enable ? backlight_config.level : 0);
 }
 
+/* set backlight from config in RAM, e.g. after suspend */
+void backlight_restore(void)
+{
+    backlight_set(backlight_config.enable ? backlight_config.level : 0);
+}
+
 void backlight_increase(void)
 {
     if(backlight_config.level < BACKLIGHT_LEVELS)
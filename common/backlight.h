@@ -30,6 +30,7 @@ typedef union {
 } backlight_config_t;
 
 void backlight_init(void);
+void backlight_restore(void);
 void backlight_increase(void);
 void backlight_decrease(void);
 void backlight_toggle(void);
@@ -9,6 +9,9 @@
 #include "action_layer.h"
 #include "eeconfig.h"
 #include "bootmagic.h"
+#ifdef KEYMAP_OVERLAY_ENABLE
+#include "keymap_overlay.h"
+#endif
 
 
 void bootmagic(void)
@@ -32,6 +35,9 @@ void bootmagic(void)
     /* eeconfig clear */
     if (bootmagic_scan_keycode(BOOTMAGIC_KEY_EEPROM_CLEAR)) {
         eeconfig_init();
+#ifdef KEYMAP_OVERLAY_ENABLE
+        keymap_overlay_clear();
+#endif
     }
 
     /* bootloader */
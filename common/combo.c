@@ -0,0 +1,201 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "progmem.h"
+#include "timer.h"
+#include "debug.h"
+#include "combo.h"
+
+
+/* combos which have the key */
+static combo_mask_t key_combos[MATRIX_ROWS][MATRIX_COLS];
+
+/* presses held back while combo is possible, all of them are in candidates */
+static keyevent_t pending[COMBO_KEYS];
+static uint8_t pending_count = 0;
+static combo_mask_t candidates = 0;
+
+/* fired combos and their keys still down */
+static combo_mask_t active = 0;
+static uint8_t held[COMBO_COUNT];
+
+
+#define COMBO_BIT(i)    ((combo_mask_t)1<<(i))
+
+static uint8_t count_of(uint8_t i)
+{
+    return pgm_read_byte(&combos[i].count);
+}
+
+static uint8_t term_of(uint8_t i)
+{
+    uint8_t term = pgm_read_byte(&combos[i].term);
+    return term ? term : COMBO_TERM;
+}
+
+static keypos_t key_of(uint8_t i, uint8_t k)
+{
+    return (keypos_t){
+        .col = pgm_read_byte(&combos[i].keys[k].col),
+        .row = pgm_read_byte(&combos[i].keys[k].row)
+    };
+}
+
+static combo_mask_t combos_of(keypos_t key)
+{
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) return 0;
+    return key_combos[key.row][key.col];
+}
+
+
+void combo_init(void)
+{
+    for (uint8_t i = 0; i < COMBO_COUNT; i++) {
+        for (uint8_t k = 0; k < count_of(i) && k < COMBO_KEYS; k++) {
+            keypos_t key = key_of(i, k);
+            if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) continue;
+            key_combos[key.row][key.col] |= COMBO_BIT(i);
+        }
+    }
+}
+
+action_t combo_get_action(keypos_t key)
+{
+    action_t action = { .code = ACTION_NO };
+    if (key.col < COMBO_COUNT) {
+        action.code = pgm_read_word(&combos[key.col].action);
+    }
+    return action;
+}
+
+
+static void fire(uint8_t i)
+{
+    dprintf("combo: fire %u\n", i);
+    held[i] = (1<<count_of(i)) - 1;
+    active |= COMBO_BIT(i);
+    action_exec((keyevent_t){
+        .key = (keypos_t){ .row = COMBO_ROW, .col = i },
+        .pressed = true,
+        .time = pending[pending_count - 1].time
+    });
+}
+
+/* fire complete combo, or pass held back presses as they were */
+static void resolve(void)
+{
+    combo_mask_t m = candidates;
+    for (uint8_t i = 0; m; i++, m >>= 1) {
+        if ((m & 1) && count_of(i) == pending_count) {
+            fire(i);
+            goto END;
+        }
+    }
+    dprintf("combo: pass %u\n", pending_count);
+    for (uint8_t k = 0; k < pending_count; k++) {
+        action_exec(pending[k]);
+    }
+END:
+    pending_count = 0;
+    candidates = 0;
+}
+
+/* drop combos not completed within term and resolve when no larger one is possible */
+static void check(uint16_t now)
+{
+    // TIMER_DIFF_16 is 1ms short across wrap around
+    uint16_t elapsed = now - pending[0].time;
+    bool waiting = false;
+    combo_mask_t m = candidates;
+    for (uint8_t i = 0; m; i++, m >>= 1) {
+        if (!(m & 1) || count_of(i) == pending_count) continue;
+        if (elapsed >= term_of(i)) {
+            candidates &= ~COMBO_BIT(i);
+        } else {
+            waiting = true;
+        }
+    }
+    if (!waiting) resolve();
+}
+
+/* release of key of fired combo; first one releases the combo */
+static bool release(uint8_t i, keypos_t key, uint16_t time)
+{
+    for (uint8_t k = 0; k < count_of(i); k++) {
+        if (!(held[i] & (1<<k)) || !KEYEQ(key_of(i, k), key)) continue;
+
+        if (held[i] == (1<<count_of(i)) - 1) {
+            action_exec((keyevent_t){
+                .key = (keypos_t){ .row = COMBO_ROW, .col = i },
+                .pressed = false,
+                .time = time
+            });
+        }
+        held[i] &= ~(1<<k);
+        if (!held[i]) active &= ~COMBO_BIT(i);
+        return true;
+    }
+    return false;
+}
+
+void combo_event(keyevent_t event)
+{
+    if (!event.pressed) {
+        // held back presses came first: any release ends waiting for the combo
+        if (pending_count) {
+            resolve();
+        }
+        combo_mask_t m = combos_of(event.key) & active;
+        for (uint8_t i = 0; m; i++, m >>= 1) {
+            if ((m & 1) && release(i, event.key, event.time)) return;
+        }
+        action_exec(event);
+        return;
+    }
+
+    if (pending_count) {
+        check(event.time);
+    }
+    if (pending_count) {
+        combo_mask_t m = candidates & combos_of(event.key);
+        if (m && pending_count < COMBO_KEYS) {
+            pending[pending_count++] = event;
+            candidates = m;
+            check(event.time);
+            return;
+        }
+        resolve();
+    }
+
+    combo_mask_t m = combos_of(event.key);
+    if (!m) {
+        action_exec(event);
+        return;
+    }
+    pending[0] = event;
+    pending_count = 1;
+    candidates = m;
+    check(event.time);
+}
+
+void combo_task(void)
+{
+    if (pending_count) {
+        check(timer_read() | 1);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef COMBO_H
+#define COMBO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+#include "action.h"
+
+
+/*
+ * Combo: keys pressed together run one action
+ *
+ * Keymap defines the table in flash:
+ *     const combo_t combos[COMBO_COUNT] PROGMEM = {
+ *         COMBO(ACTION_KEY(KC_ESC), COMBO_KEY(2, 6), COMBO_KEY(2, 7)),
+ *         COMBO_TERM_MS(30, ACTION_KEY(KC_TAB), COMBO_KEY(2, 1), COMBO_KEY(2, 2)),
+ *     };
+ * and COMBO_COUNT in config.h.
+ *
+ * A press of key which is member of no combo goes to action_exec at once.
+ * A press of member key is held back until it can't be a combo any more:
+ * other key is pressed or a held key is released, or term of the combos
+ * is over. Combo fires when all of its keys are down within its term and no
+ * larger combo with those keys is still possible; its action runs on a
+ * virtual key(COMBO_ROW, index) and is released when first of its keys is
+ * released. Releases of the other keys are dropped.
+ */
+#ifndef COMBO_TERM
+#define COMBO_TERM      50      /* ms */
+#endif
+#ifndef COMBO_COUNT
+#define COMBO_COUNT     8
+#endif
+#define COMBO_KEYS      4       /* max keys of a combo */
+#define COMBO_ROW       254     /* row of virtual keys; 255 is TICK */
+
+#if COMBO_COUNT <= 8
+typedef uint8_t combo_mask_t;
+#elif COMBO_COUNT <= 16
+typedef uint16_t combo_mask_t;
+#elif COMBO_COUNT <= 32
+typedef uint32_t combo_mask_t;
+#else
+#   error "COMBO_COUNT: 32 at most"
+#endif
+
+typedef struct {
+    keypos_t keys[COMBO_KEYS];
+    uint8_t  count;
+    uint8_t  term;              /* ms, 0: COMBO_TERM */
+    uint16_t action;
+} combo_t;
+
+#define COMBO_KEY(r, c)     { .col = (c), .row = (r) }
+#define COMBO_TERM_MS(ms, act, ...) {                           \
+    .keys = { __VA_ARGS__ },                                    \
+    .count = sizeof((keypos_t[]){ __VA_ARGS__ }) / sizeof(keypos_t), \
+    .term = (ms),                                               \
+    .action = (act)                                             \
+}
+#define COMBO(act, ...)     COMBO_TERM_MS(0, act, __VA_ARGS__)
+
+#define IS_COMBO_KEY(key)   ((key).row == COMBO_ROW)
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* defined in keymap */
+extern const combo_t combos[COMBO_COUNT];
+
+void combo_init(void);
+/* takes matrix event in place of action_exec */
+void combo_event(keyevent_t event);
+/* resolves pending combo at end of term; call when no matrix event */
+void combo_task(void);
+action_t combo_get_action(keypos_t key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
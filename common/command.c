@@ -30,9 +30,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "eeconfig.h"
 #include "sleep_led.h"
+#include "suspend.h"
+#include "key_stats.h"
 #include "led.h"
 #include "command.h"
 #include "backlight.h"
+#ifdef KEYMAP_OVERLAY_ENABLE
+#include "keymap_overlay.h"
+#endif
 
 #ifdef MOUSEKEY_ENABLE
 #include "mousekey.h"
@@ -125,6 +130,9 @@ static void command_common_help(void)
     print("t:	print timer count\n");
     print("s:	print status\n");
     print("e:	print eeprom config\n");
+#ifdef KEY_STATS_ENABLE
+    print("i:	print key statistics\n");
+#endif
 #ifdef NKRO_ENABLE
     print("n:	toggle NKRO\n");
 #endif
@@ -190,6 +198,11 @@ static bool command_common(uint8_t code)
             print("eeconfig:\n");
             print_eeconfig();
             break;
+#endif
+#ifdef KEY_STATS_ENABLE
+        case KC_I:
+            key_stats_print();
+            break;
 #endif
         case KC_CAPSLOCK:
             if (host_get_driver()) {
@@ -315,6 +328,7 @@ static bool command_common(uint8_t code)
             print_val_hex8(host_keyboard_leds());
             print_val_hex8(keyboard_protocol);
             print_val_hex8(keyboard_idle);
+            print_val_dec(suspend_wakeup_latency());
 #ifdef PROTOCOL_PJRC
             print_val_hex8(UDCON);
             print_val_hex8(UDIEN);
@@ -387,7 +401,28 @@ static void command_console_help(void)
 #ifdef MOUSEKEY_ENABLE
     print("m:	mousekey\n");
 #endif
+#ifdef KEYMAP_OVERLAY_ENABLE
+    print("k:	print keymap overlay\n");
+    print("u:	clear keymap overlay\n");
+#endif
+}
+
+#ifdef KEYMAP_OVERLAY_ENABLE
+static void print_keymap_overlay(void)
+{
+    print("\nlayer row col entry\n");
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+                keypos_t key = { .row = r, .col = c };
+                if (!keymap_overlay_has(l, key)) continue;
+                xprintf("%5u %3u %3u %04X\n", l, r, c, keymap_overlay_get(l, key));
+            }
+        }
+    }
+    if (keymap_overlay_dirty()) print("(not saved yet)\n");
 }
+#endif
 
 static bool command_console(uint8_t code)
 {
@@ -408,6 +443,15 @@ static bool command_console(uint8_t code)
             print("M0>");
             command_state = MOUSEKEY;
             return true;
+#endif
+#ifdef KEYMAP_OVERLAY_ENABLE
+        case KC_K:
+            print_keymap_overlay();
+            break;
+        case KC_U:
+            keymap_overlay_clear();
+            print("\nKeymap overlay cleared\n");
+            break;
 #endif
         default:
             print("?");
@@ -0,0 +1,335 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#endif
+#include "action_util.h"
+#include "action_macro.h"
+#include "timer.h"
+#include "debug.h"
+#include "dynamic_macro.h"
+
+
+#if DYNAMIC_MACRO_SIZE > 255
+#   error "DYNAMIC_MACRO_SIZE: 255 at most"
+#endif
+#if DYNAMIC_MACRO_SLOTS > 128
+#   error "DYNAMIC_MACRO_SLOTS: 128 at most"
+#endif
+
+/*
+ * Events which went into one report are a group and groups are separated
+ * by WAIT, even WAIT(0); player applies a whole group and sends one report,
+ * so order of events within a group doesn't matter.
+ */
+#define NONE            0xFF
+/* longest group opened by WAIT of up to DYNAMIC_MACRO_MAX_WAIT */
+#define WAIT_SIZE       (2 * (DYNAMIC_MACRO_MAX_WAIT / 255 + 1))
+/* room kept for releases at end of recording: WAIT(0), keys down and mods */
+#define TAIL_SIZE(keys) (2 + 2 * (keys) + 2)
+
+static uint8_t macros[DYNAMIC_MACRO_SLOTS][DYNAMIC_MACRO_SIZE];
+static uint8_t lengths[DYNAMIC_MACRO_SLOTS];
+
+static uint8_t rec_slot = NONE;
+static bool rec_group = false;
+static uint8_t rec_mods = 0;
+static uint16_t rec_time = 0;
+static uint8_t rec_down[32];    /* keys pressed while recording */
+static uint8_t rec_down_count = 0;
+
+static uint8_t play_slot = NONE;
+static uint8_t play_pos = 0;
+static uint16_t play_wait = 0;
+static uint16_t play_time = 0;
+
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+/* slot in EEPROM: length, checksum, data */
+#define EEPROM_SLOT(i)  ((uint8_t *)(uint16_t)(DYNAMIC_MACRO_EEPROM_ADDR + (i) * (DYNAMIC_MACRO_SIZE + 2)))
+#if DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_SLOTS * (DYNAMIC_MACRO_SIZE + 2) > E2END + 1
+#   error "DYNAMIC_MACRO_EEPROM_ADDR: slots don't fit in EEPROM"
+#endif
+static uint8_t save_slot = NONE;
+static uint8_t save_pos = 0;
+#endif
+
+
+static void record_stop(void);
+
+static uint8_t checksum(uint8_t slot)
+{
+    uint8_t sum = 0xA5 ^ lengths[slot];
+    for (uint8_t i = 0; i < lengths[slot]; i++) {
+        sum = (sum << 1 | sum >> 7) ^ macros[slot][i];
+    }
+    return sum;
+}
+
+void dynamic_macro_init(void)
+{
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    for (uint8_t i = 0; i < DYNAMIC_MACRO_SLOTS; i++) {
+        uint8_t *p = EEPROM_SLOT(i);
+        lengths[i] = eeprom_read_byte(p);
+        if (lengths[i] > DYNAMIC_MACRO_SIZE) {
+            lengths[i] = 0;
+            continue;
+        }
+        eeprom_read_block(macros[i], p + 2, lengths[i]);
+        if (eeprom_read_byte(p + 1) != checksum(i)) {
+            dprintf("dynamic_macro: slot %u broken\n", i);
+            lengths[i] = 0;
+        }
+    }
+#endif
+}
+
+
+/* true if 'n' more bytes and releases of one more key fit, otherwise recording stops */
+static bool room(uint8_t n)
+{
+    if (lengths[rec_slot] + n + TAIL_SIZE(rec_down_count + 1) <= DYNAMIC_MACRO_SIZE) return true;
+    dprintf("dynamic_macro: slot %u full\n", rec_slot);
+    record_stop();
+    return false;
+}
+
+static void put(uint8_t b)
+{
+    if (lengths[rec_slot] < DYNAMIC_MACRO_SIZE) {
+        macros[rec_slot][lengths[rec_slot]++] = b;
+    }
+}
+
+/* starts group with WAIT of time since previous report */
+static void open_group(void)
+{
+    if (rec_group) return;
+    rec_group = true;
+    if (!lengths[rec_slot]) return;
+
+    uint16_t delta = timer_elapsed(rec_time);
+    if (delta > DYNAMIC_MACRO_MAX_WAIT) delta = DYNAMIC_MACRO_MAX_WAIT;
+    do {
+        uint8_t ms = (delta > 255 ? 255 : delta);
+        put(WAIT);
+        put(ms);
+        delta -= ms;
+    } while (delta);
+}
+
+static void put_key(uint8_t code, bool pressed)
+{
+    if (code >= 0x04 && code <= 0x73) {
+        put(pressed ? code : code | 0x80);
+    } else {
+        put(pressed ? KEY_DOWN : KEY_UP);
+        put(code);
+    }
+}
+
+void dynamic_macro_key(uint8_t code, bool pressed)
+{
+    if (rec_slot == NONE) return;
+
+    uint8_t bit = 1<<(code & 7);
+    if (!pressed && !(rec_down[code>>3] & bit)) return;     // pressed before recording
+    if (!room(WAIT_SIZE + 2)) return;
+
+    open_group();
+    put_key(code, pressed);
+    if (pressed) {
+        if (!(rec_down[code>>3] & bit)) rec_down_count++;
+        rec_down[code>>3] |= bit;
+    } else {
+        rec_down[code>>3] &= ~bit;
+        rec_down_count--;
+    }
+}
+
+void dynamic_macro_mods(uint8_t mods)
+{
+    if (rec_slot == NONE) return;
+
+    if (mods != rec_mods && room(WAIT_SIZE + 2)) {
+        open_group();
+        put(DYNAMIC_MACRO_MODS);
+        put(mods);
+        rec_mods = mods;
+    }
+    // report is sent: group is closed
+    if (rec_group) {
+        rec_group = false;
+        rec_time = timer_read();
+    }
+}
+
+
+static void record_stop(void)
+{
+    uint8_t slot = rec_slot;
+
+    // release what is still down so that playback leaves nothing stuck,
+    // in a group of its own after WAIT(0) to fit in room kept by room()
+    if (lengths[slot] && (rec_down_count || rec_mods)) {
+        put(WAIT);
+        put(0);
+    }
+    for (uint8_t i = 0; i < sizeof(rec_down); i++) {
+        for (uint8_t j = 0; j < 8; j++) {
+            if (rec_down[i] & (1<<j)) put_key(i<<3 | j, false);
+        }
+    }
+    if (rec_mods) {
+        put(DYNAMIC_MACRO_MODS);
+        put(0);
+    }
+    rec_group = false;
+    rec_slot = NONE;
+    dprintf("dynamic_macro: slot %u recorded %u bytes\n", slot, lengths[slot]);
+
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    save_slot = slot;
+    save_pos = 0;
+#endif
+}
+
+void dynamic_macro_record(uint8_t slot)
+{
+    if (slot >= DYNAMIC_MACRO_SLOTS) return;
+
+    if (rec_slot != NONE) {
+        bool same = (rec_slot == slot);
+        record_stop();
+        if (same) return;
+    }
+    // playback would be recorded: stop it and release what it pressed
+    if (play_slot != NONE) {
+        play_slot = NONE;
+        clear_keys();
+        clear_weak_mods();
+        send_keyboard_report();
+    }
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    if (save_slot == slot) save_slot = NONE;
+#endif
+
+    dprintf("dynamic_macro: slot %u recording\n", slot);
+    rec_slot = slot;
+    rec_group = false;
+    rec_mods = 0;
+    lengths[slot] = 0;
+    memset(rec_down, 0, sizeof(rec_down));
+    rec_down_count = 0;
+}
+
+bool dynamic_macro_recording(void)
+{
+    return rec_slot != NONE;
+}
+
+void dynamic_macro_play(uint8_t slot)
+{
+    if (slot >= DYNAMIC_MACRO_SLOTS || !lengths[slot]) return;
+    // recording itself would be recorded
+    if (rec_slot != NONE) return;
+
+    play_slot = slot;
+    play_pos = 0;
+    play_wait = 0;
+    play_time = timer_read();
+}
+
+
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+/* writes a byte when EEPROM is ready: data first and length last */
+static void save_task(void)
+{
+    if (save_slot == NONE || !eeprom_is_ready()) return;
+
+    uint8_t *p = EEPROM_SLOT(save_slot);
+    uint8_t len = lengths[save_slot];
+    if (save_pos < len) {
+        eeprom_update_byte(p + 2 + save_pos, macros[save_slot][save_pos]);
+        save_pos++;
+    } else if (save_pos == len) {
+        eeprom_update_byte(p + 1, checksum(save_slot));
+        save_pos++;
+    } else {
+        eeprom_update_byte(p, len);
+        save_slot = NONE;
+    }
+}
+#endif
+
+void dynamic_macro_task(void)
+{
+#ifdef DYNAMIC_MACRO_EEPROM_ADDR
+    save_task();
+#endif
+    if (play_slot == NONE) return;
+
+    uint8_t *m = macros[play_slot];
+    uint8_t len = lengths[play_slot];
+
+    while (play_pos + 1 < len && m[play_pos] == WAIT) {
+        play_wait += m[play_pos + 1];
+        play_pos += 2;
+    }
+    if (play_pos >= len) {
+        play_slot = NONE;
+        return;
+    }
+    if (timer_elapsed(play_time) < play_wait ||
+        timer_elapsed(play_time) < DYNAMIC_MACRO_REPORT_INTERVAL) return;
+
+    // a group makes a report
+    while (play_pos < len && m[play_pos] != WAIT) {
+        uint8_t c = m[play_pos++];
+        uint8_t arg = (play_pos < len ? m[play_pos] : 0);
+        switch (c) {
+            case KEY_DOWN:
+                add_key(arg);
+                play_pos++;
+                break;
+            case KEY_UP:
+                del_key(arg);
+                play_pos++;
+                break;
+            case DYNAMIC_MACRO_MODS:
+                set_weak_mods(arg);
+                play_pos++;
+                break;
+            case 0x04 ... 0x73:
+                add_key(c);
+                break;
+            case 0x84 ... 0xF3:
+                del_key(c & 0x7F);
+                break;
+            default:
+                play_pos = len;
+                break;
+        }
+    }
+    send_keyboard_report();
+    play_time = timer_read();
+    play_wait = 0;
+}
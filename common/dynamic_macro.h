@@ -0,0 +1,83 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef DYNAMIC_MACRO_H
+#define DYNAMIC_MACRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*
+ * Dynamic macro: record keys on the keyboard and play them back
+ *
+ * ACTION_MACRO_RECORD(slot) starts recording and stops it on next press.
+ * Keys and modifiers are recorded as they go into keyboard report, after
+ * layers, tap keys and macros are resolved. ACTION_MACRO_PLAY(slot) plays
+ * it back from keyboard_task() without blocking scan: recorded waits are
+ * kept but reports are at least DYNAMIC_MACRO_REPORT_INTERVAL apart.
+ *
+ * Recording uses macro commands of action_macro.h: key down/up, WAIT(ms)
+ * for time between events and DYNAMIC_MACRO_MODS followed by modifier
+ * bits. Waits longer than DYNAMIC_MACRO_MAX_WAIT are cut short. Room is
+ * kept to release keys and mods still down when recording stops.
+ *
+ * With DYNAMIC_MACRO_EEPROM_ADDR slots are saved to EEPROM when recording
+ * stops and loaded at start up. Saving writes a byte per task call when
+ * EEPROM is ready and skips bytes which are unchanged.
+ */
+#ifndef DYNAMIC_MACRO_SLOTS
+#define DYNAMIC_MACRO_SLOTS         2
+#endif
+#ifndef DYNAMIC_MACRO_SIZE
+#define DYNAMIC_MACRO_SIZE          64      /* bytes per slot */
+#endif
+#ifndef DYNAMIC_MACRO_MAX_WAIT
+#define DYNAMIC_MACRO_MAX_WAIT      1000    /* ms */
+#endif
+#ifndef DYNAMIC_MACRO_REPORT_INTERVAL
+#   ifdef USB_LOW_LATENCY_ENABLE
+#   define DYNAMIC_MACRO_REPORT_INTERVAL    1
+#   else
+#   define DYNAMIC_MACRO_REPORT_INTERVAL    10
+#   endif
+#endif
+
+/* command in addition to action_macro.h */
+#define DYNAMIC_MACRO_MODS          0xF4
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void dynamic_macro_init(void);
+/* from action */
+void dynamic_macro_record(uint8_t slot);
+void dynamic_macro_play(uint8_t slot);
+/* true while recording, e.g. for LED */
+bool dynamic_macro_recording(void);
+/* from action_util while recording */
+void dynamic_macro_key(uint8_t code, bool pressed);
+void dynamic_macro_mods(uint8_t mods);
+/* from keyboard_task */
+void dynamic_macro_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,315 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include "timer.h"
+#include "debug.h"
+#include "action_layer.h"
+#include "mousekey.h"
+#include "suspend.h"
+#include "key_stats.h"
+#ifdef KEYMAP_OVERLAY_ENABLE
+#include "keymap_overlay.h"
+#endif
+#include "hid_command.h"
+
+
+/*
+ * Transport calls receive/transmit from USB interrupt while requests are
+ * processed in main loop, so EEPROM writes never stall USB. A request is
+ * owned by main loop from REQUEST until it turns into RESPONSE.
+ */
+enum { IDLE, REQUEST, RESPONSE };
+static volatile uint8_t state = IDLE;
+static uint8_t packet[HID_COMMAND_SIZE];
+
+static uint32_t scan_count = 0;
+
+/* trace ring: written by main loop, read by transport */
+static bool trace_on = false;
+static uint8_t trace_buf[HID_COMMAND_TRACE_SIZE][HID_COMMAND_TRACE_EVENT_SIZE];
+static volatile uint8_t trace_head = 0;
+static volatile uint8_t trace_tail = 0;
+static uint16_t trace_dropped = 0;
+
+
+__attribute__ ((weak))
+uint8_t hid_command_stats_kb(uint8_t *data, uint8_t size)
+{
+    return 0;
+}
+
+
+bool hid_command_ready(void)
+{
+    return state == IDLE;
+}
+
+void hid_command_receive(const uint8_t *data)
+{
+    if (state != IDLE) return;
+    memcpy(packet, data, HID_COMMAND_SIZE);
+    state = REQUEST;
+}
+
+bool hid_command_transmit(uint8_t *data)
+{
+    if (state == RESPONSE) {
+        memcpy(data, packet, HID_COMMAND_SIZE);
+        state = IDLE;
+        return true;
+    }
+
+    uint8_t tail = trace_tail;
+    if (tail == trace_head) return false;
+
+    memset(data, 0, HID_COMMAND_SIZE);
+    data[1] = HID_COMMAND_TRACE_DATA;
+    uint8_t n = 0;
+    while (tail != trace_head && n < HID_COMMAND_DATA_SIZE / HID_COMMAND_TRACE_EVENT_SIZE) {
+        memcpy(&data[3 + n * HID_COMMAND_TRACE_EVENT_SIZE], trace_buf[tail], HID_COMMAND_TRACE_EVENT_SIZE);
+        tail = (tail + 1) % HID_COMMAND_TRACE_SIZE;
+        n++;
+    }
+    data[2] = n;
+    trace_tail = tail;
+    return true;
+}
+
+
+void hid_command_trace(keyevent_t event)
+{
+    if (!trace_on) return;
+
+    uint8_t next = (trace_head + 1) % HID_COMMAND_TRACE_SIZE;
+    if (next == trace_tail) {
+        trace_dropped++;
+        return;
+    }
+    uint8_t *e = trace_buf[trace_head];
+    e[0] = event.key.row;
+    e[1] = event.key.col | (event.pressed ? 0x80 : 0);
+    e[2] = event.time & 0xFF;
+    e[3] = event.time >> 8;
+    trace_head = next;
+}
+
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, v & 0xFFFF);
+    put16(p + 2, v >> 16);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return p[0] | (uint16_t)p[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+/* args points to request arguments and data to response payload */
+static uint8_t process(uint8_t command, const uint8_t *args, uint8_t *data)
+{
+    switch (command) {
+        case HID_COMMAND_GET_VERSION:
+            data[0] = HID_COMMAND_VERSION;
+            data[1] = MATRIX_ROWS;
+            data[2] = MATRIX_COLS;
+#ifdef KEYMAP_OVERLAY_ENABLE
+            data[3] = KEYMAP_OVERLAY_LAYERS;
+#endif
+            return HID_COMMAND_OK;
+        case HID_COMMAND_EEPROM_READ:
+        case HID_COMMAND_EEPROM_WRITE: {
+            uint16_t addr = get16(args);
+            uint8_t len = args[2];
+            if (len > HID_COMMAND_DATA_SIZE - 3 || (uint32_t)addr + len > (uint32_t)E2END + 1)
+                return HID_COMMAND_BAD_ARGUMENT;
+            if (command == HID_COMMAND_EEPROM_WRITE) {
+                eeprom_update_block(&args[3], (void *)addr, len);
+            }
+            eeprom_read_block(data, (const void *)addr, len);
+            return HID_COMMAND_OK;
+        }
+        case HID_COMMAND_LAYER_GET:
+            put32(&data[0], layer_state);
+            put32(&data[4], default_layer_state);
+            return HID_COMMAND_OK;
+        case HID_COMMAND_LAYER_SET:
+#ifndef NO_ACTION_LAYER
+            layer_clear();
+            layer_or(get32(args));
+            return HID_COMMAND_OK;
+#else
+            return HID_COMMAND_UNSUPPORTED;
+#endif
+        case HID_COMMAND_DEFAULT_LAYER_SET:
+            default_layer_set(get32(args));
+            return HID_COMMAND_OK;
+        case HID_COMMAND_DEBUG_SET:
+            debug_config.raw = args[0];
+            /* fall through */
+        case HID_COMMAND_DEBUG_GET:
+            data[0] = debug_config.raw;
+            return HID_COMMAND_OK;
+#ifdef MOUSEKEY_ENABLE
+        case HID_COMMAND_MOUSEKEY_SET:
+            mk_delay             = args[0];
+            mk_interval          = args[1];
+            mk_max_speed         = args[2];
+            mk_time_to_max       = args[3];
+            mk_wheel_max_speed   = args[4];
+            mk_wheel_time_to_max = args[5];
+            /* fall through */
+        case HID_COMMAND_MOUSEKEY_GET:
+            data[0] = mk_delay;
+            data[1] = mk_interval;
+            data[2] = mk_max_speed;
+            data[3] = mk_time_to_max;
+            data[4] = mk_wheel_max_speed;
+            data[5] = mk_wheel_time_to_max;
+            return HID_COMMAND_OK;
+#else
+        case HID_COMMAND_MOUSEKEY_SET:
+        case HID_COMMAND_MOUSEKEY_GET:
+            return HID_COMMAND_UNSUPPORTED;
+#endif
+        case HID_COMMAND_STATS:
+            put32(&data[0], timer_read32());
+            put32(&data[4], scan_count);
+            put16(&data[8], trace_dropped);
+            put16(&data[10], suspend_wakeup_latency());
+            hid_command_stats_kb(&data[12], HID_COMMAND_DATA_SIZE - 12);
+            return HID_COMMAND_OK;
+        case HID_COMMAND_TRACE:
+            trace_on = args[0];
+            trace_dropped = 0;
+            return HID_COMMAND_OK;
+#ifdef KEY_STATS_ENABLE
+        case HID_COMMAND_KEY_STATS: {
+            keypos_t key = { .row = args[0], .col = args[1] };
+            if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS)
+                return HID_COMMAND_BAD_ARGUMENT;
+            uint8_t n = 0;
+            for (; key.col < MATRIX_COLS && n < (HID_COMMAND_DATA_SIZE - 1) / HID_COMMAND_KEY_STATS_SIZE; key.col++, n++) {
+                uint8_t *p = &data[1 + n * HID_COMMAND_KEY_STATS_SIZE];
+                put16(&p[0], key_stats_time(key));
+#ifdef KEY_STATS_COUNTER
+                put16(&p[2], key_stats_presses(key));
+                p[4] = key_stats_chatter(key);
+#endif
+            }
+            data[0] = n;
+            return HID_COMMAND_OK;
+        }
+        case HID_COMMAND_KEY_HOLD: {
+#ifdef KEY_STATS_COUNTER
+            uint8_t b = args[0];
+            uint8_t n = 0;
+            for (; b < KEY_STATS_BUCKETS && n < (HID_COMMAND_DATA_SIZE - 2) / 2; b++, n++) {
+                put16(&data[2 + n * 2], key_stats_hold(b));
+            }
+            data[0] = n;
+            data[1] = KEY_STATS_BUCKET_TIME;
+            return HID_COMMAND_OK;
+#else
+            return HID_COMMAND_UNSUPPORTED;
+#endif
+        }
+        case HID_COMMAND_KEY_STATS_CLEAR:
+            key_stats_clear();
+            return HID_COMMAND_OK;
+#else
+        case HID_COMMAND_KEY_STATS:
+        case HID_COMMAND_KEY_HOLD:
+        case HID_COMMAND_KEY_STATS_CLEAR:
+            return HID_COMMAND_UNSUPPORTED;
+#endif
+#ifdef KEYMAP_OVERLAY_ENABLE
+        case HID_COMMAND_KEYMAP_GET: {
+            uint8_t layer = args[0];
+            keypos_t key = { .row = args[1], .col = args[2] };
+            if (layer >= KEYMAP_OVERLAY_LAYERS || key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS)
+                return HID_COMMAND_BAD_ARGUMENT;
+            uint8_t n = 0;
+            for (; key.col < MATRIX_COLS && n < (HID_COMMAND_DATA_SIZE - 1) / HID_COMMAND_KEYMAP_SIZE; key.col++, n++) {
+                uint8_t *p = &data[1 + n * HID_COMMAND_KEYMAP_SIZE];
+                if (keymap_overlay_has(layer, key)) {
+                    p[0] = 1;
+                    put16(&p[1], keymap_overlay_get(layer, key));
+                }
+            }
+            data[0] = n;
+            return HID_COMMAND_OK;
+        }
+        case HID_COMMAND_KEYMAP_SET: {
+            keypos_t key = { .row = args[1], .col = args[2] };
+            uint16_t entry = get16(&args[3]);
+            if (entry != (keymap_overlay_t)entry || !keymap_overlay_set(args[0], key, entry))
+                return HID_COMMAND_BAD_ARGUMENT;
+            return HID_COMMAND_OK;
+        }
+        case HID_COMMAND_KEYMAP_DEL: {
+            keypos_t key = { .row = args[1], .col = args[2] };
+            if (!keymap_overlay_del(args[0], key))
+                return HID_COMMAND_BAD_ARGUMENT;
+            return HID_COMMAND_OK;
+        }
+        case HID_COMMAND_KEYMAP_CLEAR:
+            keymap_overlay_clear();
+            return HID_COMMAND_OK;
+#else
+        case HID_COMMAND_KEYMAP_GET:
+        case HID_COMMAND_KEYMAP_SET:
+        case HID_COMMAND_KEYMAP_DEL:
+        case HID_COMMAND_KEYMAP_CLEAR:
+            return HID_COMMAND_UNSUPPORTED;
+#endif
+        default:
+            return HID_COMMAND_UNKNOWN;
+    }
+}
+
+void hid_command_task(void)
+{
+    scan_count++;
+
+    if (state != REQUEST) return;
+
+    uint8_t args[HID_COMMAND_SIZE - 1];
+    uint8_t command = packet[0];
+    memcpy(args, &packet[1], sizeof(args));
+
+    memset(packet, 0, HID_COMMAND_SIZE);
+    packet[1] = command;
+    packet[2] = process(command, args, &packet[3]);
+    dprintf("hid_command: %02X %u\n", command, packet[2]);
+    state = RESPONSE;
+}
@@ -0,0 +1,102 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef HID_COMMAND_H
+#define HID_COMMAND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+
+/*
+ * Binary command channel
+ *
+ * Host sends a request packet of HID_COMMAND_SIZE bytes:
+ *     [command, arguments...]
+ * and firmware answers with a packet on the same interface:
+ *     [0x00, command, status, data...]
+ * The leading zero keeps text console listeners(hid_listen) from printing
+ * responses, and command is never zero so padding packets of the text
+ * console are told apart. Multi-byte values are little endian.
+ *
+ * While trace is on, matrix events are streamed as unsolicited packets:
+ *     [0x00, HID_COMMAND_TRACE_DATA, count, event * count]
+ * where each event is [row, col | pressed<<7, time(2)].
+ */
+#define HID_COMMAND_SIZE            32
+#define HID_COMMAND_DATA_SIZE       (HID_COMMAND_SIZE - 3)
+#define HID_COMMAND_VERSION         1
+
+/* command */
+#define HID_COMMAND_GET_VERSION     0x01    /* -> version, rows, cols, overlay layers */
+#define HID_COMMAND_EEPROM_READ     0x02    /* addr(2), len -> data */
+#define HID_COMMAND_EEPROM_WRITE    0x03    /* addr(2), len, data */
+#define HID_COMMAND_LAYER_GET       0x04    /* -> layer_state(4), default_layer_state(4) */
+#define HID_COMMAND_LAYER_SET       0x05    /* layer_state(4) */
+#define HID_COMMAND_DEFAULT_LAYER_SET 0x06  /* default_layer_state(4) */
+#define HID_COMMAND_DEBUG_GET       0x07    /* -> debug_config */
+#define HID_COMMAND_DEBUG_SET       0x08    /* debug_config */
+#define HID_COMMAND_MOUSEKEY_GET    0x09    /* -> delay, interval, max_speed, time_to_max, wheel_max_speed, wheel_time_to_max */
+#define HID_COMMAND_MOUSEKEY_SET    0x0A    /* same as above */
+#define HID_COMMAND_STATS           0x0B    /* -> time(4), scans(4), trace_dropped(2), wakeup_latency(2), keyboard stats... */
+#define HID_COMMAND_TRACE           0x0C    /* on */
+#define HID_COMMAND_KEY_STATS       0x0D    /* row, col -> count, (time(2), presses(2), chatter) * count */
+#define HID_COMMAND_KEY_HOLD        0x0E    /* bucket -> count, bucket_time, hold(2) * count */
+#define HID_COMMAND_KEY_STATS_CLEAR 0x0F
+#define HID_COMMAND_KEYMAP_GET      0x10    /* layer, row, col -> count, (changed, entry(2)) * count */
+#define HID_COMMAND_KEYMAP_SET      0x11    /* layer, row, col, entry(2) */
+#define HID_COMMAND_KEYMAP_DEL      0x12    /* layer, row, col */
+#define HID_COMMAND_KEYMAP_CLEAR    0x13
+#define HID_COMMAND_TRACE_DATA      0x80    /* unsolicited */
+
+/* status */
+#define HID_COMMAND_OK              0
+#define HID_COMMAND_UNKNOWN         1
+#define HID_COMMAND_BAD_ARGUMENT    2
+#define HID_COMMAND_UNSUPPORTED     3
+
+#define HID_COMMAND_TRACE_EVENT_SIZE    4
+#define HID_COMMAND_KEY_STATS_SIZE      5
+#define HID_COMMAND_KEYMAP_SIZE         3
+#ifndef HID_COMMAND_TRACE_SIZE
+#define HID_COMMAND_TRACE_SIZE      32
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* transport: request can be received only when previous one is answered */
+bool hid_command_ready(void);
+void hid_command_receive(const uint8_t *data);
+/* transport: fill response or trace packet, false if nothing to send */
+bool hid_command_transmit(uint8_t *data);
+
+/* process request in main loop */
+void hid_command_task(void);
+/* record matrix event to trace */
+void hid_command_trace(keyevent_t event);
+
+/* keyboard specific counters appended to HID_COMMAND_STATS; returns length */
+uint8_t hid_command_stats_kb(uint8_t *data, uint8_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -19,6 +19,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //#include <avr/interrupt.h>
 #include "keycode.h"
 #include "host.h"
+#include "timer.h"
 #include "util.h"
 #include "debug.h"
 
@@ -31,10 +32,114 @@ static host_driver_t *driver;
 static uint16_t last_system_report = 0;
 static uint16_t last_consumer_report = 0;
 
+/* state last sent, replayed to new driver on handover */
+static report_keyboard_t last_keyboard_report = {};
+static uint8_t last_mouse_buttons = 0;
+
+/* previous driver still fed during handover */
+static host_driver_t *overlap_driver = 0;
+static uint16_t overlap_start = 0;
+static uint16_t overlap_term = 0;
+static uint16_t handover_time = 0;
+
+#ifdef MOUSE_ENABLE
+/* mouse motion not sent yet */
+static struct {
+    uint8_t buttons;
+    int16_t x;
+    int16_t y;
+    int16_t v;
+    int16_t h;
+} mouse_pending = {};
+static bool mouse_pending_flag = false;
+static uint16_t mouse_last_time = 0;
+
+static void mouse_flush(void);
+#endif
+
+
+/* sends released state so that no key is left stuck on the host */
+static void release_all(host_driver_t *d)
+{
+    report_keyboard_t report = {};
+    (*d->send_keyboard)(&report);
+    if (last_mouse_buttons) {
+        report_mouse_t mouse = {};
+        (*d->send_mouse)(&mouse);
+    }
+    if (last_system_report) (*d->send_system)(0);
+    if (last_consumer_report) (*d->send_consumer)(0);
+}
+
+/* old driver of handover is sent released state; handover is complete */
+static void overlap_end(void)
+{
+    release_all(overlap_driver);
+    overlap_driver = 0;
+    handover_time = timer_elapsed(overlap_start);
+    dprintf("host: handover %ums\n", handover_time);
+}
 
 void host_set_driver(host_driver_t *d)
 {
     driver = d;
+    if (overlap_driver) {
+        // old driver of a handover still in overlap would keep keys stuck
+        overlap_end();
+    }
+}
+
+static void replay_all(host_driver_t *d)
+{
+    (*d->send_keyboard)(&last_keyboard_report);
+    if (last_mouse_buttons) {
+        report_mouse_t mouse = { .buttons = last_mouse_buttons };
+        (*d->send_mouse)(&mouse);
+    }
+    if (last_system_report) (*d->send_system)(last_system_report);
+    if (last_consumer_report) (*d->send_consumer)(last_consumer_report);
+}
+
+/*
+ * Switches to driver 'd' without dropping held keys: current state is sent to
+ * the new driver at once. Reports also go to the old driver for 'overlap' ms,
+ * then it is sent released state.
+ */
+void host_handover(host_driver_t *d, uint16_t overlap)
+{
+    uint16_t t = timer_read();
+    host_driver_t *old = driver;
+
+    if (overlap_driver) overlap_end();
+    driver = d;
+    if (old && old != d) {
+        if (overlap) {
+            overlap_driver = old;
+            overlap_start = t;
+            overlap_term = overlap;
+        } else {
+            release_all(old);
+        }
+    }
+    if (d) replay_all(d);
+
+    // with overlap handover lasts until old driver is released
+    if (!overlap_driver) {
+        handover_time = timer_elapsed(t);
+        dprintf("host: handover %ums\n", handover_time);
+    }
+}
+
+uint16_t host_handover_time(void)
+{
+    return handover_time;
+}
+
+void host_task(void)
+{
+    if (overlap_driver && timer_elapsed(overlap_start) >= overlap_term) {
+        overlap_end();
+    }
 }
 
 host_driver_t *host_get_driver(void)
@@ -47,11 +152,21 @@ uint8_t host_keyboard_leds(void)
     if (!driver) return 0;
     return (*driver->keyboard_leds)();
 }
+
+uint8_t host_keyboard_caps(void)
+{
+    if (!driver || !driver->keyboard_caps) return HOST_KEYBOARD_BOOT;
+    return (*driver->keyboard_caps)();
+}
+
 /* send report */
 void host_keyboard_send(report_keyboard_t *report)
 {
+    last_keyboard_report = *report;
+
     if (!driver) return;
     (*driver->send_keyboard)(report);
+    if (overlap_driver) (*overlap_driver->send_keyboard)(report);
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -64,10 +179,78 @@ void host_keyboard_send(report_keyboard_t *report)
 
 void host_mouse_send(report_mouse_t *report)
 {
+    last_mouse_buttons = report->buttons;
+
     if (!driver) return;
     (*driver->send_mouse)(report);
+    if (overlap_driver) (*overlap_driver->send_mouse)(report);
+}
+
+#ifdef MOUSE_ENABLE
+static int16_t add_sat16(int16_t a, int16_t b)
+{
+    int32_t r = (int32_t)a + b;
+    return (r > INT16_MAX ? INT16_MAX : (r < -INT16_MAX ? -INT16_MAX : r));
+}
+
+static int16_t clamp16(int16_t a, int16_t max)
+{
+    return (a > max ? max : (a < -max ? -max : a));
 }
 
+/*
+ * Accumulates motion until next report. Button change is sent at once
+ * with motion accumulated so far so that no click is lost.
+ */
+void host_mouse_move(uint8_t buttons, int16_t x, int16_t y, int16_t v, int16_t h)
+{
+    mouse_pending.x = add_sat16(mouse_pending.x, x);
+    mouse_pending.y = add_sat16(mouse_pending.y, y);
+    mouse_pending.v = add_sat16(mouse_pending.v, v);
+    mouse_pending.h = add_sat16(mouse_pending.h, h);
+
+    if (buttons != mouse_pending.buttons) {
+        mouse_pending.buttons = buttons;
+        mouse_flush();
+        return;
+    }
+    if (x || y || v || h) {
+        mouse_pending_flag = true;
+    }
+}
+
+void host_mouse_task(void)
+{
+    if (!mouse_pending_flag) return;
+    if (timer_elapsed(mouse_last_time) < MOUSE_REPORT_INTERVAL) return;
+    mouse_flush();
+}
+
+/* Clamps to report range only here; remainder is carried to next report. */
+static void mouse_flush(void)
+{
+    report_mouse_t report = {
+        .buttons = mouse_pending.buttons,
+        .x = clamp16(mouse_pending.x, MOUSE_XY_MAX),
+        .y = clamp16(mouse_pending.y, MOUSE_XY_MAX),
+        .v = clamp16(mouse_pending.v, MOUSE_WHEEL_MAX),
+        .h = clamp16(mouse_pending.h, MOUSE_WHEEL_MAX)
+    };
+    mouse_pending.x -= report.x;
+    mouse_pending.y -= report.y;
+    mouse_pending.v -= report.v;
+    mouse_pending.h -= report.h;
+    mouse_pending_flag = (mouse_pending.x || mouse_pending.y ||
+                          mouse_pending.v || mouse_pending.h);
+
+    host_mouse_send(&report);
+    mouse_last_time = timer_read();
+}
+#else
+void host_mouse_move(uint8_t buttons, int16_t x, int16_t y, int16_t v, int16_t h) {}
+void host_mouse_task(void) {}
+#endif
+
 void host_system_send(uint16_t report)
 {
     if (report == last_system_report) return;
@@ -75,6 +258,7 @@ void host_system_send(uint16_t report)
 
     if (!driver) return;
     (*driver->send_system)(report);
+    if (overlap_driver) (*overlap_driver->send_system)(report);
 }
 
 void host_consumer_send(uint16_t report)
@@ -84,6 +268,7 @@ void host_consumer_send(uint16_t report)
 
     if (!driver) return;
     (*driver->send_consumer)(report);
+    if (overlap_driver) (*overlap_driver->send_consumer)(report);
 }
 
 uint16_t host_last_sysytem_report(void)
@@ -24,6 +24,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host_driver.h"
 
 
+/* interval(ms) to send accumulated mouse motion; match polling interval of endpoint */
+#ifndef MOUSE_REPORT_INTERVAL
+#   ifdef USB_LOW_LATENCY_ENABLE
+#   define MOUSE_REPORT_INTERVAL    1
+#   else
+#   define MOUSE_REPORT_INTERVAL    10
+#   endif
+#endif
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -39,14 +49,24 @@ extern uint8_t keyboard_protocol;
 /* host driver */
 void host_set_driver(host_driver_t *driver);
 host_driver_t *host_get_driver(void);
+/* switches driver keeping held keys; old one is fed for 'overlap' ms */
+void host_handover(host_driver_t *driver, uint16_t overlap);
+/* time(ms) of last handover, until old driver is sent released state */
+uint16_t host_handover_time(void);
+void host_task(void);
 
 /* host driver interface */
 uint8_t host_keyboard_leds(void);
+uint8_t host_keyboard_caps(void);
 void host_keyboard_send(report_keyboard_t *report);
 void host_mouse_send(report_mouse_t *report);
 void host_system_send(uint16_t data);
 void host_consumer_send(uint16_t data);
 
+/* mouse motion is accumulated and sent once per MOUSE_REPORT_INTERVAL */
+void host_mouse_move(uint8_t buttons, int16_t x, int16_t y, int16_t v, int16_t h);
+void host_mouse_task(void);
+
 uint16_t host_last_sysytem_report(void);
 uint16_t host_last_consumer_report(void);
 
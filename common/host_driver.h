@@ -28,6 +28,12 @@ typedef struct {
     void (*send_mouse)(report_mouse_t *);
     void (*send_system)(uint16_t);
     void (*send_consumer)(uint16_t);
+    /* optional; returns HOST_KEYBOARD_* report formats send_keyboard can carry */
+    uint8_t (*keyboard_caps)(void);
 } host_driver_t;
 
+/* keyboard report formats; boot report is always supported */
+#define HOST_KEYBOARD_BOOT      0
+#define HOST_KEYBOARD_HYBRID    (1<<0)
+
 #endif
@@ -0,0 +1,72 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "action_layer.h"
+#include "indicator.h"
+#include "debug.h"
+
+
+/*
+ * Layer indicators
+ *
+ * Layer change only marks indicators dirty. Bits are computed at most once
+ * per keyboard_task() and hardware is written only when they change.
+ */
+static bool layer_dirty = true;
+static bool force_write = true;
+static uint8_t indicator_bits = 0;
+
+
+void indicator_layer_changed(void)
+{
+    layer_dirty = true;
+}
+
+void indicator_refresh(void)
+{
+    force_write = true;
+}
+
+void indicator_task(void)
+{
+    uint8_t bits = indicator_bits;
+
+    if (layer_dirty) {
+        layer_dirty = false;
+        bits = indicator_layer(layer_state, default_layer_state);
+    }
+
+    if (bits != indicator_bits || force_write) {
+        force_write = false;
+        indicator_bits = bits;
+        if (debug_keyboard) { debug("indicator: "); debug_hex8(bits); debug("\n"); }
+        indicator_write(bits);
+    }
+}
+
+
+__attribute__ ((weak))
+uint8_t indicator_layer(uint32_t state, uint32_t default_state)
+{
+    return 0;
+}
+
+__attribute__ ((weak))
+void indicator_write(uint8_t bits)
+{
+}
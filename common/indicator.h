@@ -0,0 +1,47 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef INDICATOR_H
+#define INDICATOR_H
+
+#include <stdint.h>
+
+
+#ifdef INDICATOR_ENABLE
+
+/* notify change of layer state; indicators are updated in indicator_task() */
+void indicator_layer_changed(void);
+/* write indicators to hardware again even if not changed */
+void indicator_refresh(void);
+void indicator_task(void);
+
+/*
+ * Keyboard specific
+ */
+/* returns indicator bits for the layer state */
+uint8_t indicator_layer(uint32_t state, uint32_t default_state);
+/* writes indicator bits to hardware; called only when bits change */
+void indicator_write(uint8_t bits);
+
+#else
+
+#define indicator_layer_changed()
+#define indicator_refresh()
+#define indicator_task()
+
+#endif
+
+#endif
@@ -0,0 +1,139 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "keycode.h"
+#include "host.h"
+#include "action_util.h"
+#include "timer.h"
+#include "key_repeat.h"
+
+
+static uint8_t repeat_code = 0;
+static uint8_t repeat_class = KEY_REPEAT_NONE;
+static uint16_t repeat_time = 0;    /* when next repeat is due */
+/* true while repeat itself deletes and adds the key */
+static bool repeating = false;
+
+#if KEY_REPEAT_REFRESH > 0
+static uint16_t refresh_time = 0;
+static bool refresh_held = false;
+#endif
+
+
+__attribute__ ((weak))
+uint8_t key_repeat_class(uint8_t code)
+{
+    switch (code) {
+        case KC_CAPSLOCK:
+        case KC_SCROLLLOCK:
+        case KC_NUMLOCK:
+        case KC_PAUSE:
+        case KC_INSERT:
+            return KEY_REPEAT_NONE;
+        case KC_BSPACE:
+        case KC_DELETE:
+        case KC_RIGHT:
+        case KC_LEFT:
+        case KC_DOWN:
+        case KC_UP:
+        case KC_PGUP:
+        case KC_PGDOWN:
+            return KEY_REPEAT_FAST;
+        default:
+            return KEY_REPEAT_NORMAL;
+    }
+}
+
+static uint16_t delay_of(uint8_t class)
+{
+    switch (class) {
+        case KEY_REPEAT_NORMAL: return KEY_REPEAT_DELAY;
+        case KEY_REPEAT_FAST:   return KEY_REPEAT_FAST_DELAY;
+        default:                return 0;
+    }
+}
+
+static uint16_t interval_of(uint8_t class)
+{
+    return (class == KEY_REPEAT_FAST ? KEY_REPEAT_FAST_INTERVAL : KEY_REPEAT_INTERVAL);
+}
+
+/* true when time 't' has come; works over timer wrap within 32s */
+static bool is_due(uint16_t now, uint16_t t)
+{
+    return TIMER_DIFF_16(now, t) < 0x8000;
+}
+
+
+void key_repeat_press(uint8_t code)
+{
+    if (repeating) return;
+
+    uint8_t class = key_repeat_class(code);
+    uint16_t delay = delay_of(class);
+    if (!delay) {
+        repeat_code = 0;
+        return;
+    }
+    repeat_code = code;
+    repeat_class = class;
+    repeat_time = timer_read() + delay;
+}
+
+void key_repeat_release(uint8_t code)
+{
+    if (repeating) return;
+    if (code == repeat_code) repeat_code = 0;
+}
+
+void key_repeat_clear(void)
+{
+    if (repeating) return;
+    repeat_code = 0;
+}
+
+void key_repeat_task(void)
+{
+    uint16_t now = timer_read();
+
+    if (repeat_code && is_due(now, repeat_time)) {
+        // release and press again in a row; both are whole reports so order can't mix
+        repeating = true;
+        del_key(repeat_code);
+        send_keyboard_report();
+        add_key(repeat_code);
+        send_keyboard_report();
+        repeating = false;
+
+        repeat_time += interval_of(repeat_class);
+        if (is_due(now, repeat_time)) {
+            // stalled longer than interval; don't burst to catch up
+            repeat_time = now + interval_of(repeat_class);
+        }
+    }
+
+#if KEY_REPEAT_REFRESH > 0
+    if (TIMER_DIFF_16(now, refresh_time) >= KEY_REPEAT_REFRESH) {
+        refresh_time = now;
+        bool held = (has_anykey() || keyboard_report->mods);
+        // send once more after release in case the release was lost
+        if (held || refresh_held) host_keyboard_send(keyboard_report);
+        refresh_held = held;
+    }
+#endif
+}
@@ -0,0 +1,81 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef KEY_REPEAT_H
+#define KEY_REPEAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*
+ * Key repeat in firmware
+ *
+ * For hosts and links which have no auto repeat of their own, or whose
+ * repeat can't be trusted. The key pressed last repeats after delay of its
+ * class at interval of the class: report without the key is sent and then
+ * report with it again. Repeat stops when the key is released or other key
+ * is pressed, and the next one is scheduled from when this one was due so
+ * that scan time doesn't slow the rate down.
+ *
+ * With KEY_REPEAT_REFRESH current report is sent again every that ms while
+ * any key or modifier is held and once after release. Reports are state, not
+ * events, so a lost press or release on Bluetooth link is fixed by next one
+ * instead of leaving the host repeating a key.
+ */
+#ifndef KEY_REPEAT_DELAY
+#define KEY_REPEAT_DELAY            500     /* ms, 0: no repeat */
+#endif
+#ifndef KEY_REPEAT_INTERVAL
+#define KEY_REPEAT_INTERVAL         33      /* ms */
+#endif
+#ifndef KEY_REPEAT_FAST_DELAY
+#define KEY_REPEAT_FAST_DELAY       250
+#endif
+#ifndef KEY_REPEAT_FAST_INTERVAL
+#define KEY_REPEAT_FAST_INTERVAL    20
+#endif
+#ifndef KEY_REPEAT_REFRESH
+#define KEY_REPEAT_REFRESH          0       /* ms, 0: off */
+#endif
+
+/* key class */
+enum key_repeat_class {
+    KEY_REPEAT_NONE,        /* lock keys */
+    KEY_REPEAT_NORMAL,
+    KEY_REPEAT_FAST,        /* backspace, delete and cursor keys */
+};
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* from action_util when key is added to or deleted from report */
+void key_repeat_press(uint8_t code);
+void key_repeat_release(uint8_t code);
+void key_repeat_clear(void);
+/* from keyboard_task */
+void key_repeat_task(void);
+
+/* keymap can override classes of keys */
+uint8_t key_repeat_class(uint8_t code);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
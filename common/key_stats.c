@@ -0,0 +1,118 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "timer.h"
+#include "print.h"
+#include "key_stats.h"
+
+
+static uint16_t edge_time[MATRIX_ROWS][MATRIX_COLS];
+#ifdef KEY_STATS_COUNTER
+static uint16_t presses[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t chatter[MATRIX_ROWS][MATRIX_COLS];
+static uint16_t hold[KEY_STATS_BUCKETS];
+#endif
+
+
+void key_stats_event(keyevent_t event)
+{
+    uint8_t r = event.key.row;
+    uint8_t c = event.key.col;
+    if (r >= MATRIX_ROWS || c >= MATRIX_COLS) return;
+
+#ifdef KEY_STATS_COUNTER
+    uint16_t last = edge_time[r][c];
+    uint16_t elapsed = TIMER_DIFF_16(event.time, last);
+
+    if (last && elapsed < KEY_STATS_CHATTER_TIME) {
+        if (chatter[r][c] < UINT8_MAX) chatter[r][c]++;
+    }
+    if (event.pressed) {
+        if (presses[r][c] < UINT16_MAX) presses[r][c]++;
+    } else if (last) {
+        uint16_t b = elapsed / KEY_STATS_BUCKET_TIME;
+        if (b >= KEY_STATS_BUCKETS) b = KEY_STATS_BUCKETS - 1;
+        if (hold[b] < UINT16_MAX) hold[b]++;
+    }
+#endif
+    // event time is never 0
+    edge_time[r][c] = event.time;
+}
+
+void key_stats_clear(void)
+{
+    memset(edge_time, 0, sizeof(edge_time));
+#ifdef KEY_STATS_COUNTER
+    memset(presses, 0, sizeof(presses));
+    memset(chatter, 0, sizeof(chatter));
+    memset(hold, 0, sizeof(hold));
+#endif
+}
+
+uint16_t key_stats_time(keypos_t key)
+{
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) return 0;
+    return edge_time[key.row][key.col];
+}
+
+#ifdef KEY_STATS_COUNTER
+uint16_t key_stats_presses(keypos_t key)
+{
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) return 0;
+    return presses[key.row][key.col];
+}
+
+uint8_t key_stats_chatter(keypos_t key)
+{
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) return 0;
+    return chatter[key.row][key.col];
+}
+
+uint16_t key_stats_hold(uint8_t bucket)
+{
+    if (bucket >= KEY_STATS_BUCKETS) return 0;
+    return hold[bucket];
+}
+#endif
+
+void key_stats_print(void)
+{
+    print("\n\n----- Key Stats -----\n");
+#ifdef KEY_STATS_COUNTER
+    print("r/c: presses chatter last\n");
+#else
+    print("r/c: last\n");
+#endif
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+            if (!edge_time[r][c]) continue;
+#ifdef KEY_STATS_COUNTER
+            xprintf("%02X/%02X: %u %u %u\n", r, c, presses[r][c], chatter[r][c], edge_time[r][c]);
+#else
+            xprintf("%02X/%02X: %u\n", r, c, edge_time[r][c]);
+#endif
+        }
+    }
+#ifdef KEY_STATS_COUNTER
+    print("hold(ms): count\n");
+    for (uint8_t b = 0; b < KEY_STATS_BUCKETS; b++) {
+        xprintf("%u-: %u\n", b * KEY_STATS_BUCKET_TIME, hold[b]);
+    }
+#endif
+}
@@ -0,0 +1,69 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef KEY_STATS_H
+#define KEY_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+
+/*
+ * Key statistics
+ *
+ * Time of last edge is kept for every key. With KEY_STATS_COUNTER in
+ * config.h presses and chatter of every key and histogram of hold time of
+ * all keys are counted as well. Chatter is an edge which comes within
+ * KEY_STATS_CHATTER_TIME after previous edge of the same key, what a
+ * finger can't do but a failing switch does after debounce.
+ *
+ * Statistics are updated only on key events, scans without change cost
+ * nothing.
+ */
+#ifndef KEY_STATS_CHATTER_TIME
+#define KEY_STATS_CHATTER_TIME      20      /* ms */
+#endif
+#ifndef KEY_STATS_BUCKETS
+#define KEY_STATS_BUCKETS           16
+#endif
+#ifndef KEY_STATS_BUCKET_TIME
+#define KEY_STATS_BUCKET_TIME       32      /* ms; last bucket counts longer holds */
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void key_stats_event(keyevent_t event);
+void key_stats_clear(void);
+
+/* time of last edge, 0 if no edge yet */
+uint16_t key_stats_time(keypos_t key);
+#ifdef KEY_STATS_COUNTER
+uint16_t key_stats_presses(keypos_t key);
+uint8_t key_stats_chatter(keypos_t key);
+uint16_t key_stats_hold(uint8_t bucket);
+#endif
+
+void key_stats_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "bootmagic.h"
 #include "eeconfig.h"
 #include "backlight.h"
+#include "indicator.h"
 #ifdef MOUSEKEY_ENABLE
 #   include "mousekey.h"
 #endif
@@ -39,6 +40,27 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef SERIAL_MOUSE_ENABLE
 #include "serial_mouse.h"
 #endif
+#ifdef HID_COMMAND_ENABLE
+#   include "hid_command.h"
+#endif
+#ifdef KEY_STATS_ENABLE
+#   include "key_stats.h"
+#endif
+#ifdef COMBO_ENABLE
+#   include "combo.h"
+#endif
+#ifdef KEY_REPEAT_ENABLE
+#   include "key_repeat.h"
+#endif
+#ifdef STENO_ENABLE
+#   include "steno.h"
+#endif
+#ifdef DYNAMIC_MACRO_ENABLE
+#   include "dynamic_macro.h"
+#endif
+#ifdef KEYMAP_OVERLAY_ENABLE
+#   include "keymap_overlay.h"
+#endif
 
 
 #ifdef MATRIX_HAS_GHOST
@@ -71,6 +93,11 @@ void keyboard_init(void)
 #endif
 
 
+#ifdef KEYMAP_OVERLAY_ENABLE
+    /* before bootmagic which can clear it */
+    keymap_overlay_init();
+#endif
+
 #ifdef BOOTMAGIC_ENABLE
     bootmagic();
 #endif
@@ -78,6 +105,32 @@ void keyboard_init(void)
 #ifdef BACKLIGHT_ENABLE
     backlight_init();
 #endif
+
+#ifdef COMBO_ENABLE
+    combo_init();
+#endif
+
+#ifdef DYNAMIC_MACRO_ENABLE
+    dynamic_macro_init();
+#endif
+}
+
+static matrix_row_t matrix_prev[MATRIX_ROWS];
+/* keys pressed to wake host up; processed as pressed once even if released before resume */
+static matrix_row_t matrix_wakeup[MATRIX_ROWS];
+
+void keyboard_wakeup_keys(void)
+{
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_wakeup[r] = matrix_get_row(r) & ~matrix_prev[r];
+    }
+}
+
+void keyboard_wakeup_clear(void)
+{
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_wakeup[r] = 0;
+    }
 }
 
 /*
@@ -86,14 +139,14 @@ void keyboard_init(void)
  */
 void keyboard_task(void)
 {
-    static matrix_row_t matrix_prev[MATRIX_ROWS];
     static uint8_t led_status = 0;
+    uint8_t leds;
     matrix_row_t matrix_row = 0;
     matrix_row_t matrix_change = 0;
 
     matrix_scan();
     for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-        matrix_row = matrix_get_row(r);
+        matrix_row = matrix_get_row(r) | matrix_wakeup[r];
         matrix_change = matrix_row ^ matrix_prev[r];
         if (matrix_change) {
             if (debug_matrix) matrix_print();
@@ -105,19 +158,35 @@ void keyboard_task(void)
 #endif
             for (uint8_t c = 0; c < MATRIX_COLS; c++) {
                 if (matrix_change & ((matrix_row_t)1<<c)) {
-                    action_exec((keyevent_t){
+                    keyevent_t e = (keyevent_t){
                         .key = (keypos_t){ .row = r, .col = c },
                         .pressed = (matrix_row & ((matrix_row_t)1<<c)),
                         .time = (timer_read() | 1) /* time should not be 0 */
-                    });
+                    };
+#ifdef KEY_STATS_ENABLE
+                    key_stats_event(e);
+#endif
+#ifdef HID_COMMAND_ENABLE
+                    hid_command_trace(e);
+#endif
+#ifdef COMBO_ENABLE
+                    combo_event(e);
+#else
+                    action_exec(e);
+#endif
                     // record a processed key
                     matrix_prev[r] ^= ((matrix_row_t)1<<c);
+                    matrix_wakeup[r] &= ~((matrix_row_t)1<<c);
                     // process a key per task call
                     goto MATRIX_LOOP_END;
                 }
             }
         }
     }
+#ifdef COMBO_ENABLE
+    // fire or pass combo keys held back when combo term is over
+    combo_task();
+#endif
     // call with pseudo tick event when no real key event.
     action_exec(TICK);
 
@@ -136,11 +205,48 @@ MATRIX_LOOP_END:
         serial_mouse_task();
 #endif
 
+#ifdef MOUSE_ENABLE
+    // send mouse motion accumulated since last report
+    host_mouse_task();
+#endif
+
+#ifdef KEY_REPEAT_ENABLE
+    // repeat held key and refresh report
+    key_repeat_task();
+#endif
+
+#ifdef STENO_ENABLE
+    // type text of steno strokes
+    steno_task();
+#endif
+
+#ifdef DYNAMIC_MACRO_ENABLE
+    // play recorded macro and save it to EEPROM
+    dynamic_macro_task();
+#endif
+
+#ifdef KEYMAP_OVERLAY_ENABLE
+    // save changed keys to EEPROM
+    keymap_overlay_task();
+#endif
+
+    // finish driver handover
+    host_task();
+
     // update LED
-    if (led_status != host_keyboard_leds()) {
-        led_status = host_keyboard_leds();
+    leds = host_keyboard_leds();
+    if (led_status != leds) {
+        led_status = leds;
         keyboard_set_leds(led_status);
     }
+
+    // update layer indicators only when layer state changes
+    indicator_task();
+
+#ifdef HID_COMMAND_ENABLE
+    // process request from host
+    hid_command_task();
+#endif
 }
 
 void keyboard_set_leds(uint8_t leds)
@@ -61,9 +61,15 @@ static inline bool IS_RELEASED(keyevent_t event) { return (!IS_NOEVENT(event) &&
 void keyboard_init(void);
 void keyboard_task(void);
 void keyboard_set_leds(uint8_t leds);
+/* keep keys currently pressed until processed, called when they wake host up */
+void keyboard_wakeup_keys(void);
+/* forget keys kept by keyboard_wakeup_keys(), called when host doesn't resume */
+void keyboard_wakeup_clear(void);
 
 __attribute__ ((weak)) void matrix_power_up(void) {}
 __attribute__ ((weak)) void matrix_power_down(void) {}
+__attribute__ ((weak)) bool matrix_wakeup_enable(void) { return false; }
+__attribute__ ((weak)) void matrix_wakeup_disable(void) {}
 
 #ifdef __cplusplus
 }
@@ -21,87 +21,196 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action.h"
 #include "action_macro.h"
 #include "debug.h"
+#if defined(ACTIONMAP_ENABLE) || defined(KEYMAP_SPARSE_ENABLE)
+#include <avr/pgmspace.h>
+#endif
+#ifdef KEYMAP_SPARSE_ENABLE
+#include "util.h"
+#endif
+#ifdef KEYMAP_OVERLAY_ENABLE
+#include "keymap_overlay.h"
+#endif
 
 
+#ifndef ACTIONMAP_ENABLE
 static action_t keycode_to_action(uint8_t keycode);
+#endif
+#ifdef BOOTMAGIC_ENABLE
+static uint8_t bootmagic_keycode(uint8_t keycode);
+#endif
+
 
+#ifdef KEYMAP_SPARSE_ENABLE
+/* layer bitmap of key word k */
+static uint32_t sparse_layers(uint16_t k)
+{
+    return pgm_read_keymap_layers(&keymap_sparse_layers[KEYMAP_SPARSE_BITMAP(k)]);
+}
+
+/* layers which define key(non-transparent) */
+uint32_t keymap_layers_for_key(keypos_t key)
+{
+    return sparse_layers(pgm_read_word(&keymap_sparse_keys[(key.row)][(key.col)]));
+}
+
+/* entry of key on layer, or 'transparent' when layer doesn't define key */
+static uint16_t sparse_entry(uint8_t layer, keypos_t key, uint16_t transparent)
+{
+    uint16_t k = pgm_read_word(&keymap_sparse_keys[(key.row)][(key.col)]);
+    uint32_t layers = sparse_layers(k);
+    if (!(layers & (1UL<<layer))) {
+        return transparent;
+    }
+
+    /* first entry of the key, then skip its lower layers */
+    uint16_t i = KEYMAP_SPARSE_INDEX(k) + bitpop32(layers & ((1UL<<layer) - 1));
+#ifdef ACTIONMAP_ENABLE
+    return pgm_read_word(&keymap_sparse_entries[i]);
+#else
+    return pgm_read_byte(&keymap_sparse_entries[i]);
+#endif
+}
+#endif
+
+
+#ifdef ACTIONMAP_ENABLE
+/* converts key to action
+ *
+ * Actions are precompiled per key by tool/actionmap, so this is a single
+ * flash read unless the key is changed in keymap overlay. Bootmagic swaps
+ * are applied on top as a small overlay.
+ */
+action_t action_for_key(uint8_t layer, keypos_t key)
+{
+    action_t action;
+#ifdef KEYMAP_OVERLAY_ENABLE
+    if (keymap_overlay_has(layer, key)) {
+        action.code = keymap_overlay_get(layer, key);
+    } else
+#endif
+#ifdef KEYMAP_SPARSE_ENABLE
+    action.code = sparse_entry(layer, key, ACTION_TRANSPARENT);
+#else
+    action.code = pgm_read_word(&actionmaps[(layer)][(key.row)][(key.col)]);
+#endif
 
+    switch (action.kind.id) {
+        case ACT_ACTIONMAP_FN:
+            return keymap_fn_to_action(action.key.code);
+#ifdef BOOTMAGIC_ENABLE
+        case ACT_LMODS:
+            /* swaps only ever apply to plain keys */
+            if ((keymap_config.raw & ~KEYMAP_CONFIG_NKRO) && !action.key.mods) {
+                action.code = ACTION_KEY(bootmagic_keycode(action.key.code));
+            }
+            return action;
+#endif
+        default:
+            return action;
+    }
+}
+#else
 /* converts key to action */
 action_t action_for_key(uint8_t layer, keypos_t key)
 {
-    uint8_t keycode = keymap_key_to_keycode(layer, key);
+    uint8_t keycode;
+#ifdef KEYMAP_OVERLAY_ENABLE
+    if (keymap_overlay_has(layer, key)) {
+        keycode = keymap_overlay_get(layer, key);
+    } else
+#endif
+#ifdef KEYMAP_SPARSE_ENABLE
+    keycode = sparse_entry(layer, key, KC_TRNS);
+#else
+    keycode = keymap_key_to_keycode(layer, key);
+#endif
     switch (keycode) {
         case KC_FN0 ... KC_FN31:
             return keymap_fn_to_action(keycode);
+        default:
+#ifdef BOOTMAGIC_ENABLE
+            return keycode_to_action(bootmagic_keycode(keycode));
+#else
+            return keycode_to_action(keycode);
+#endif
+    }
+}
+#endif
+
+
 #ifdef BOOTMAGIC_ENABLE
+/* remaps keycode according to bootmagic swap settings */
+static uint8_t bootmagic_keycode(uint8_t keycode)
+{
+    switch (keycode) {
         case KC_CAPSLOCK:
         case KC_LOCKING_CAPS:
             if (keymap_config.swap_control_capslock || keymap_config.capslock_to_control) {
-                return keycode_to_action(KC_LCTL);
+                return KC_LCTL;
             }
-            return keycode_to_action(keycode);
+            return keycode;
         case KC_LCTL:
             if (keymap_config.swap_control_capslock) {
-                return keycode_to_action(KC_CAPSLOCK);
+                return KC_CAPSLOCK;
             }
-            return keycode_to_action(KC_LCTL);
+            return KC_LCTL;
         case KC_LALT:
             if (keymap_config.swap_lalt_lgui) {
                 if (keymap_config.no_gui) {
-                    return keycode_to_action(ACTION_NO);
+                    return KC_NO;
                 }
-                return keycode_to_action(KC_LGUI);
+                return KC_LGUI;
             }
-            return keycode_to_action(KC_LALT);
+            return KC_LALT;
         case KC_LGUI:
             if (keymap_config.swap_lalt_lgui) {
-                return keycode_to_action(KC_LALT);
+                return KC_LALT;
             }
             if (keymap_config.no_gui) {
-                return keycode_to_action(ACTION_NO);
+                return KC_NO;
             }
-            return keycode_to_action(KC_LGUI);
+            return KC_LGUI;
         case KC_RALT:
             if (keymap_config.swap_ralt_rgui) {
                 if (keymap_config.no_gui) {
-                    return keycode_to_action(ACTION_NO);
+                    return KC_NO;
                 }
-                return keycode_to_action(KC_RGUI);
+                return KC_RGUI;
             }
-            return keycode_to_action(KC_RALT);
+            return KC_RALT;
         case KC_RGUI:
             if (keymap_config.swap_ralt_rgui) {
-                return keycode_to_action(KC_RALT);
+                return KC_RALT;
             }
             if (keymap_config.no_gui) {
-                return keycode_to_action(ACTION_NO);
+                return KC_NO;
             }
-            return keycode_to_action(KC_RGUI);
+            return KC_RGUI;
         case KC_GRAVE:
             if (keymap_config.swap_grave_esc) {
-                return keycode_to_action(KC_ESC);
+                return KC_ESC;
             }
-            return keycode_to_action(KC_GRAVE);
+            return KC_GRAVE;
         case KC_ESC:
             if (keymap_config.swap_grave_esc) {
-                return keycode_to_action(KC_GRAVE);
+                return KC_GRAVE;
             }
-            return keycode_to_action(KC_ESC);
+            return KC_ESC;
         case KC_BSLASH:
             if (keymap_config.swap_backslash_backspace) {
-                return keycode_to_action(KC_BSPACE);
+                return KC_BSPACE;
             }
-            return keycode_to_action(KC_BSLASH);
+            return KC_BSLASH;
         case KC_BSPACE:
             if (keymap_config.swap_backslash_backspace) {
-                return keycode_to_action(KC_BSLASH);
+                return KC_BSLASH;
             }
-            return keycode_to_action(KC_BSPACE);
-#endif
+            return KC_BSPACE;
         default:
-            return keycode_to_action(keycode);
+            return keycode;
     }
 }
+#endif
 
 
 /* Macro */
@@ -119,6 +228,7 @@ void action_function(keyrecord_t *record, uint8_t id, uint8_t opt)
 
 
 
+#ifndef ACTIONMAP_ENABLE
 /* translates keycode to action */
 static action_t keycode_to_action(uint8_t keycode)
 {
@@ -146,6 +256,7 @@ static action_t keycode_to_action(uint8_t keycode)
     }
     return action;
 }
+#endif
 
 
 
@@ -39,6 +39,7 @@ typedef union {
     };
 } keymap_config_t;
 keymap_config_t keymap_config;
+#define KEYMAP_CONFIG_NKRO  (1<<7)
 #endif
 
 
@@ -49,6 +50,64 @@ uint8_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
 action_t keymap_fn_to_action(uint8_t keycode);
 
 
+/* Precompiled actionmap(generated by tool/actionmap)
+ *
+ * 0110|0000| keycode     Fn key resolved by keymap_fn_to_action() at runtime
+ *
+ * Used when Fn actions depend on runtime state(e.g. current layer). This code
+ * is consumed by action_for_key() and never reaches the action executor.
+ */
+#define ACT_ACTIONMAP_FN        0b0110
+#define ACTIONMAP_FN(keycode)   ACTION(ACT_ACTIONMAP_FN, (keycode))
+
+#if defined(ACTIONMAP_ENABLE) && !defined(KEYMAP_SPARSE_ENABLE)
+extern const uint16_t actionmaps[][MATRIX_ROWS][MATRIX_COLS];
+#endif
+
+
+#ifdef KEYMAP_SPARSE_ENABLE
+/* Sparse keymap(generated by tool/actionmap with SPARSE=yes)
+ *
+ * Only non-transparent entries are stored, key by key in ascending order of
+ * layer. Entries are actions with ACTIONMAP_ENABLE, otherwise keycodes.
+ *
+ *   keymap_sparse_keys:    per key, index of its first entry(low bits) and
+ *                          of its bitmap in keymap_sparse_layers(high bits)
+ *   keymap_sparse_layers:  distinct bitmaps of layers which define a key
+ *
+ * Keys share bitmaps, so a keymap can have up to 64 of them and 1024 entries.
+ */
+#define KEYMAP_SPARSE_INDEX_BITS    10
+#define KEYMAP_SPARSE_INDEX(k)      ((k) & ((1<<KEYMAP_SPARSE_INDEX_BITS) - 1))
+#define KEYMAP_SPARSE_BITMAP(k)     ((k) >> KEYMAP_SPARSE_INDEX_BITS)
+
+#ifndef KEYMAP_SPARSE_LAYERS
+#define KEYMAP_SPARSE_LAYERS    16
+#endif
+#if KEYMAP_SPARSE_LAYERS <= 8
+typedef uint8_t keymap_layers_t;
+#define pgm_read_keymap_layers(p)   pgm_read_byte(p)
+#elif KEYMAP_SPARSE_LAYERS <= 16
+typedef uint16_t keymap_layers_t;
+#define pgm_read_keymap_layers(p)   pgm_read_word(p)
+#else
+typedef uint32_t keymap_layers_t;
+#define pgm_read_keymap_layers(p)   pgm_read_dword(p)
+#endif
+
+extern const uint16_t keymap_sparse_keys[MATRIX_ROWS][MATRIX_COLS];
+extern const keymap_layers_t keymap_sparse_layers[];
+#ifdef ACTIONMAP_ENABLE
+extern const uint16_t keymap_sparse_entries[];
+#else
+extern const uint8_t keymap_sparse_entries[];
+#endif
+
+/* layers which define key(non-transparent) */
+uint32_t keymap_layers_for_key(keypos_t key);
+#endif
+
+
 
 #ifdef USE_LEGACY_KEYMAP
 /* 
@@ -0,0 +1,262 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include "timer.h"
+#include "debug.h"
+#include "keymap_overlay.h"
+#ifdef DYNAMIC_MACRO_ENABLE
+#include "dynamic_macro.h"
+#endif
+
+
+#define MAGIC           0x4F4B
+#define HEADER_SIZE     6
+#define ENTRY_BYTES     (sizeof(keymap_overlay_t))
+
+/* size of EEPROM image for preprocessor */
+#if MATRIX_COLS <= 8
+#   define ROW_BYTES    1
+#elif MATRIX_COLS <= 16
+#   define ROW_BYTES    2
+#else
+#   define ROW_BYTES    4
+#endif
+#ifdef ACTIONMAP_ENABLE
+#   define IMAGE_ENTRY_BYTES    2
+#else
+#   define IMAGE_ENTRY_BYTES    1
+#endif
+#define IMAGE_SIZE      (HEADER_SIZE + KEYMAP_OVERLAY_LAYERS * MATRIX_ROWS * (ROW_BYTES + MATRIX_COLS * IMAGE_ENTRY_BYTES))
+
+/* eeconfig uses 0-6 */
+#if KEYMAP_OVERLAY_EEPROM_ADDR < 7
+#   error "KEYMAP_OVERLAY_EEPROM_ADDR: overlaps eeconfig"
+#endif
+#if KEYMAP_OVERLAY_EEPROM_ADDR + IMAGE_SIZE > E2END + 1
+#   error "KEYMAP_OVERLAY_EEPROM_ADDR: overlay doesn't fit in EEPROM"
+#endif
+#if defined(DYNAMIC_MACRO_ENABLE) && defined(DYNAMIC_MACRO_EEPROM_ADDR)
+#   if KEYMAP_OVERLAY_EEPROM_ADDR < DYNAMIC_MACRO_EEPROM_ADDR + DYNAMIC_MACRO_SLOTS * (DYNAMIC_MACRO_SIZE + 2) && \
+       DYNAMIC_MACRO_EEPROM_ADDR < KEYMAP_OVERLAY_EEPROM_ADDR + IMAGE_SIZE
+#   error "KEYMAP_OVERLAY_EEPROM_ADDR: overlaps DYNAMIC_MACRO_EEPROM_ADDR"
+#   endif
+#endif
+
+#define EEPROM_BASE     ((uint8_t *)(uint16_t)KEYMAP_OVERLAY_EEPROM_ADDR)
+#define EEPROM_BITMAP   (EEPROM_BASE + HEADER_SIZE)
+#define EEPROM_ENTRIES  (EEPROM_BITMAP + sizeof(keymap_overlay_bitmap))
+
+#define NONE            0xFF
+#define COLS_MASK       ((matrix_row_t)(((matrix_row_t)1<<(MATRIX_COLS - 1)) * 2 - 1))
+
+
+matrix_row_t keymap_overlay_bitmap[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS];
+keymap_overlay_t keymap_overlay_entries[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS][MATRIX_COLS];
+
+/* keys to be saved */
+static matrix_row_t dirty[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS];
+static bool pending = false;
+static bool header_ok = false;
+static uint16_t last_change = 0;
+
+/* key being saved: bit off if needed, entry bytes, then its bit */
+static uint8_t save_layer = NONE;
+static keypos_t save_key;
+static uint8_t save_step = 0;
+static uint8_t header_pos = 0;
+
+static const uint8_t header[HEADER_SIZE] = {
+    MAGIC & 0xFF, MAGIC >> 8, KEYMAP_OVERLAY_LAYERS, MATRIX_ROWS, MATRIX_COLS, ENTRY_BYTES
+};
+
+
+void keymap_overlay_init(void)
+{
+    for (uint8_t i = 0; i < HEADER_SIZE; i++) {
+        if (eeprom_read_byte(EEPROM_BASE + i) != header[i]) {
+            dprintf("keymap_overlay: no overlay in EEPROM\n");
+            return;
+        }
+    }
+    eeprom_read_block(keymap_overlay_bitmap, EEPROM_BITMAP, sizeof(keymap_overlay_bitmap));
+    eeprom_read_block(keymap_overlay_entries, EEPROM_ENTRIES, sizeof(keymap_overlay_entries));
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            keymap_overlay_bitmap[l][r] &= COLS_MASK;
+        }
+    }
+    header_ok = true;
+}
+
+uint32_t keymap_overlay_layers(keypos_t key)
+{
+    uint32_t layers = 0;
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+        if (keymap_overlay_has(l, key)) layers |= 1UL<<l;
+    }
+    return layers;
+}
+
+
+static void changed(uint8_t layer, keypos_t key)
+{
+    dirty[layer][key.row] |= (matrix_row_t)1<<key.col;
+    pending = true;
+    last_change = timer_read();
+}
+
+static bool in_range(uint8_t layer, keypos_t key)
+{
+    return layer < KEYMAP_OVERLAY_LAYERS && key.row < MATRIX_ROWS && key.col < MATRIX_COLS;
+}
+
+bool keymap_overlay_set(uint8_t layer, keypos_t key, keymap_overlay_t entry)
+{
+    if (!in_range(layer, key)) return false;
+    if (keymap_overlay_has(layer, key) && keymap_overlay_get(layer, key) == entry) return true;
+
+    keymap_overlay_entries[layer][key.row][key.col] = entry;
+    keymap_overlay_bitmap[layer][key.row] |= (matrix_row_t)1<<key.col;
+    changed(layer, key);
+    return true;
+}
+
+bool keymap_overlay_del(uint8_t layer, keypos_t key)
+{
+    if (!in_range(layer, key)) return false;
+    if (!keymap_overlay_has(layer, key)) return true;
+
+    keymap_overlay_bitmap[layer][key.row] &= ~((matrix_row_t)1<<key.col);
+    changed(layer, key);
+    return true;
+}
+
+void keymap_overlay_clear(void)
+{
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            if (!keymap_overlay_bitmap[l][r]) continue;
+            dirty[l][r] |= keymap_overlay_bitmap[l][r];
+            keymap_overlay_bitmap[l][r] = 0;
+            pending = true;
+        }
+    }
+    last_change = timer_read();
+}
+
+bool keymap_overlay_dirty(void)
+{
+    return pending;
+}
+
+
+/* picks next key to save, false if none */
+static bool next_dirty(void)
+{
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            matrix_row_t d = dirty[l][r];
+            if (!d) continue;
+            uint8_t c = 0;
+            while (!(d & 1)) { d >>= 1; c++; }
+            dirty[l][r] &= ~((matrix_row_t)1<<c);
+            save_layer = l;
+            save_key = (keypos_t){ .row = r, .col = c };
+            save_step = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* writes bit of key being saved to EEPROM bitmap */
+static void write_bit(bool on)
+{
+    uint16_t row = save_layer * MATRIX_ROWS + save_key.row;
+    uint8_t *p = EEPROM_BITMAP + row * sizeof(matrix_row_t) + save_key.col / 8;
+    uint8_t bit = 1<<(save_key.col % 8);
+    uint8_t b = eeprom_read_byte(p);
+    if (!header_ok) {
+        // image is not valid until header is written: whole byte at once
+        b = ((uint8_t *)&keymap_overlay_bitmap[save_layer][save_key.row])[save_key.col / 8];
+    } else if (on) {
+        // only bit of this key: other keys in the byte may not have their entry saved yet
+        b |= bit;
+    } else {
+        b &= ~bit;
+    }
+    eeprom_update_byte(p, b);
+}
+
+/* writes a byte when EEPROM is ready */
+void keymap_overlay_task(void)
+{
+    if (!pending) return;
+    if (timer_elapsed(last_change) < KEYMAP_OVERLAY_SAVE_DELAY) return;
+    if (!eeprom_is_ready()) return;
+
+    if (!header_ok && header_pos == 0 && save_layer == NONE) {
+        // bitmap in EEPROM is not ours: every byte of it has to be written
+        for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+            for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+                dirty[l][r] = COLS_MASK;
+            }
+        }
+        header_pos = HEADER_SIZE;
+    }
+
+    if (save_layer == NONE && !next_dirty()) {
+        if (!header_ok) {
+            // header last, magic at the end: image is valid only when complete
+            header_pos--;
+            eeprom_update_byte(EEPROM_BASE + header_pos, header[header_pos]);
+            if (header_pos) return;
+            header_ok = true;
+        }
+        pending = false;
+        dprintf("keymap_overlay: saved\n");
+        return;
+    }
+
+    uint16_t offset = (save_layer * MATRIX_ROWS + save_key.row) * MATRIX_COLS + save_key.col;
+    uint8_t *ee_entry = EEPROM_ENTRIES + offset * ENTRY_BYTES;
+    uint8_t *entry = (uint8_t *)&keymap_overlay_entries[save_layer][save_key.row][save_key.col];
+    bool has = keymap_overlay_has(save_layer, save_key);
+
+    // entry of more than a byte is written with its bit off: half written entry is never live
+    if (save_step == 0) {
+        save_step++;
+        if (ENTRY_BYTES > 1 && header_ok && has) {
+            for (uint8_t i = 0; i < ENTRY_BYTES; i++) {
+                if (eeprom_read_byte(ee_entry + i) != entry[i]) {
+                    write_bit(false);
+                    return;
+                }
+            }
+        }
+    }
+    if (save_step <= ENTRY_BYTES && has) {
+        eeprom_update_byte(ee_entry + save_step - 1, entry[save_step - 1]);
+        save_step++;
+        return;
+    }
+    write_bit(has);
+    save_layer = NONE;
+}
@@ -0,0 +1,100 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef KEYMAP_OVERLAY_H
+#define KEYMAP_OVERLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+#include "matrix.h"
+
+
+/*
+ * Keymap overlay: keys changed at runtime on top of keymap in flash
+ *
+ * Layers 0 to KEYMAP_OVERLAY_LAYERS-1 have a copy in RAM and a bitmap of
+ * keys which are changed. Keys not in the bitmap are read from flash as
+ * before, so lookup costs one bit test more. Entries are actions with
+ * ACTIONMAP_ENABLE, otherwise keycodes, and Fn keys and bootmagic swaps
+ * apply to them as to flash.
+ *
+ * Overlay is loaded from EEPROM at start up. Changes are saved when no
+ * change is made for KEYMAP_OVERLAY_SAVE_DELAY, a byte per task call when
+ * EEPROM is ready and only bytes which differ. EEPROM image is:
+ *     magic(2), layers, rows, cols, entry size, bitmap, entries
+ * and is ignored when it doesn't match the firmware.
+ */
+#ifndef KEYMAP_OVERLAY_LAYERS
+#define KEYMAP_OVERLAY_LAYERS       2
+#endif
+#ifndef KEYMAP_OVERLAY_EEPROM_ADDR
+#define KEYMAP_OVERLAY_EEPROM_ADDR  256
+#endif
+#ifndef KEYMAP_OVERLAY_SAVE_DELAY
+#define KEYMAP_OVERLAY_SAVE_DELAY   3000    /* ms */
+#endif
+
+#if KEYMAP_OVERLAY_LAYERS > 32
+#   error "KEYMAP_OVERLAY_LAYERS: 32 at most"
+#endif
+
+#ifdef ACTIONMAP_ENABLE
+typedef uint16_t keymap_overlay_t;
+#else
+typedef uint8_t keymap_overlay_t;
+#endif
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern matrix_row_t keymap_overlay_bitmap[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS];
+extern keymap_overlay_t keymap_overlay_entries[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS][MATRIX_COLS];
+
+/* true if key is changed on layer */
+static inline bool keymap_overlay_has(uint8_t layer, keypos_t key)
+{
+    return layer < KEYMAP_OVERLAY_LAYERS &&
+           (keymap_overlay_bitmap[layer][key.row] & ((matrix_row_t)1<<key.col));
+}
+
+/* entry of changed key; valid only when keymap_overlay_has() */
+static inline keymap_overlay_t keymap_overlay_get(uint8_t layer, keypos_t key)
+{
+    return keymap_overlay_entries[layer][key.row][key.col];
+}
+
+/* layers which have key changed */
+uint32_t keymap_overlay_layers(keypos_t key);
+
+/* false if out of range */
+bool keymap_overlay_set(uint8_t layer, keypos_t key, keymap_overlay_t entry);
+bool keymap_overlay_del(uint8_t layer, keypos_t key);
+/* back to keymap in flash */
+void keymap_overlay_clear(void);
+/* true while changes are waiting to be saved */
+bool keymap_overlay_dirty(void);
+
+void keymap_overlay_init(void);
+void keymap_overlay_task(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -60,6 +60,10 @@ void matrix_print(void);
 /* power control */
 void matrix_power_up(void);
 void matrix_power_down(void);
+/* wake MCU from sleep on key press: drive all lines and enable pin change
+ * interrupt which calls suspend_wakeup_event(). return false if not supported */
+bool matrix_wakeup_enable(void);
+void matrix_wakeup_disable(void);
 
 #ifdef __cplusplus
 }
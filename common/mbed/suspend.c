@@ -1,6 +1,9 @@
+#include <stdint.h>
 #include <stdbool.h>
 
 
 void suspend_power_down(void) {}
 bool suspend_wakeup_condition(void) { return true; }
 void suspend_wakeup_init(void) {}
+void suspend_wakeup_event(void) {}
+uint16_t suspend_wakeup_latency(void) { return 0; }
@@ -171,7 +171,8 @@ void mousekey_off(uint8_t code)
 void mousekey_send(void)
 {
     mousekey_debug();
-    host_mouse_send(&mouse_report);
+    host_mouse_move(mouse_report.buttons, mouse_report.x, mouse_report.y,
+                    mouse_report.v, mouse_report.h);
     last_timer = timer_read();
 }
 
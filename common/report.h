@@ -85,11 +85,32 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #   define KEYBOARD_REPORT_KEYS (NKRO_EPSIZE - 2)
 #   define KEYBOARD_REPORT_BITS (NKRO_EPSIZE - 1)
 
+#elif defined(HYBRID_KRO_ENABLE)
+    /* boot report followed by bitmap of usage 0x00-(KEYBOARD_REPORT_BITS*8-1) */
+#   ifndef KEYBOARD_HYBRID_BITS
+#       define KEYBOARD_HYBRID_BITS 21
+#   endif
+#   define KEYBOARD_REPORT_SIZE (8 + KEYBOARD_HYBRID_BITS)
+#   define KEYBOARD_REPORT_KEYS 6
+#   define KEYBOARD_REPORT_BITS KEYBOARD_HYBRID_BITS
+
 #else
 #   define KEYBOARD_REPORT_SIZE 8
 #   define KEYBOARD_REPORT_KEYS 6
 #endif
 
+/* boot protocol report: mods, reserved and 6 keys */
+#define KEYBOARD_REPORT_BOOT_SIZE   8
+
+#if defined(HYBRID_KRO_ENABLE) && (defined(NKRO_ENABLE) || defined(USB_6KRO_ENABLE))
+#   error "HYBRID_KRO_ENABLE can't be used with NKRO_ENABLE or USB_6KRO_ENABLE."
+#endif
+
+/* 16-bit mouse report needs its own descriptor; only LUFA has it */
+#if defined(MOUSE_16BIT_ENABLE) && !defined(PROTOCOL_LUFA)
+#   error "MOUSE_16BIT_ENABLE is supported only with LUFA protocol."
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -108,6 +129,15 @@ extern "C" {
  * -----+--------+--------+--------+--------+--------+--------+--------+--------     +--------
  * desc |mods    |bits[0] |bits[1] |bits[2] |bits[3] |bits[4] |bits[5] |bits[6]  ... |bit[14]
  *
+ * Hybrid report keeps boot report as its first 8 bytes and appends bitmap of
+ * keys when HYBRID_KRO_ENABLE. BIOS and boot protocol host read the first 8
+ * bytes as usual, while report descriptor declares keys[] as padding so that
+ * OS takes keys only from the bitmap.
+ *
+ * byte |0       |1       |2       |3       ... |7       |8       |9        ... |28
+ * -----+--------+--------+--------+--------     +--------+--------+--------     +--------
+ * desc |mods    |reserved|keys[0] |keys[1] ... |keys[5] |bits[0] |bits[1]  ... |bits[20]
+ *
  * mods retains state of 8 modifiers.
  *
  *  bit |0       |1       |2       |3       |4       |5       |6       |7
@@ -128,6 +158,14 @@ typedef union {
         uint8_t bits[KEYBOARD_REPORT_BITS];
     } nkro;
 #endif
+#ifdef HYBRID_KRO_ENABLE
+    struct {
+        uint8_t mods;
+        uint8_t reserved;
+        uint8_t keys[KEYBOARD_REPORT_KEYS];
+        uint8_t bits[KEYBOARD_REPORT_BITS];
+    } hybrid;
+#endif
 } __attribute__ ((packed)) report_keyboard_t;
 /*
 typedef struct {
@@ -137,10 +175,31 @@ typedef struct {
 } __attribute__ ((packed)) report_keyboard_t;
 */
 
+/*
+ * mouse report retains buttons, X/Y movement and wheels.
+ * X/Y are extended to 16-bit when MOUSE_16BIT_ENABLE is defined(LUFA only).
+ *
+ * byte |0       |1       |2       |3       |4
+ * -----+--------+--------+--------+--------+--------
+ * desc |buttons |x       |y       |v       |h
+ *
+ * byte |0       |1       |2       |3       |4       |5       |6
+ * -----+--------+--------+--------+--------+--------+--------+--------
+ * desc |buttons |x(L)    |x(H)    |y(L)    |y(H)    |v       |h
+ */
+#ifdef MOUSE_16BIT_ENABLE
+typedef int16_t mouse_xy_t;
+#   define MOUSE_XY_MAX     32767
+#else
+typedef int8_t mouse_xy_t;
+#   define MOUSE_XY_MAX     127
+#endif
+#define MOUSE_WHEEL_MAX     127
+
 typedef struct {
     uint8_t buttons;
-    int8_t x;
-    int8_t y;
+    mouse_xy_t x;
+    mouse_xy_t y;
     int8_t v;
     int8_t h;
 } __attribute__ ((packed)) report_mouse_t;
@@ -0,0 +1,185 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "progmem.h"
+#include "keycode.h"
+#include "action_util.h"
+#include "timer.h"
+#include "debug.h"
+#include "steno.h"
+
+
+/* keycode of ASCII character with Shift in bit 7, 0 if not typable(US layout) */
+#define SHIFTED(kc)     ((kc) | 0x80)
+static const uint8_t ascii_to_key[0x80] PROGMEM = {
+    ['\b'] = KC_BSPC,   ['\t'] = KC_TAB,    ['\n'] = KC_ENT,    [' '] = KC_SPC,
+    ['!'] = SHIFTED(KC_1),      ['"'] = SHIFTED(KC_QUOT),   ['#'] = SHIFTED(KC_3),
+    ['$'] = SHIFTED(KC_4),      ['%'] = SHIFTED(KC_5),      ['&'] = SHIFTED(KC_7),
+    ['\''] = KC_QUOT,           ['('] = SHIFTED(KC_9),      [')'] = SHIFTED(KC_0),
+    ['*'] = SHIFTED(KC_8),      ['+'] = SHIFTED(KC_EQL),    [','] = KC_COMM,
+    ['-'] = KC_MINS,            ['.'] = KC_DOT,             ['/'] = KC_SLSH,
+    ['0'] = KC_0,   ['1'] = KC_1,   ['2'] = KC_2,   ['3'] = KC_3,   ['4'] = KC_4,
+    ['5'] = KC_5,   ['6'] = KC_6,   ['7'] = KC_7,   ['8'] = KC_8,   ['9'] = KC_9,
+    [':'] = SHIFTED(KC_SCLN),   [';'] = KC_SCLN,            ['<'] = SHIFTED(KC_COMM),
+    ['='] = KC_EQL,             ['>'] = SHIFTED(KC_DOT),    ['?'] = SHIFTED(KC_SLSH),
+    ['@'] = SHIFTED(KC_2),      ['['] = KC_LBRC,            ['\\'] = KC_BSLS,
+    [']'] = KC_RBRC,            ['^'] = SHIFTED(KC_6),      ['_'] = SHIFTED(KC_MINS),
+    ['`'] = KC_GRV,             ['{'] = SHIFTED(KC_LBRC),   ['|'] = SHIFTED(KC_BSLS),
+    ['}'] = SHIFTED(KC_RBRC),   ['~'] = SHIFTED(KC_GRV),
+};
+
+static uint8_t char_to_key(uint8_t c)
+{
+    if (c >= 'a' && c <= 'z') return KC_A + (c - 'a');
+    if (c >= 'A' && c <= 'Z') return SHIFTED(KC_A + (c - 'A'));
+    if (c >= 0x80) return 0;
+    return pgm_read_byte(&ascii_to_key[c]);
+}
+
+
+/* chord being stroked */
+static uint32_t chord = 0;
+static uint32_t chord_down = 0;
+
+/* words to type: offset of text in steno_dict_entries and length left */
+static struct {
+    uint16_t offset;
+    uint8_t  len;
+} queue[STENO_QUEUE_SIZE];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+
+/* key and Shift in the report now */
+static uint8_t cur_key = 0;
+static bool cur_shift = false;
+static uint16_t last_report = 0;
+
+
+static uint32_t get32(uint16_t offset)
+{
+    return (uint32_t)pgm_read_word(&steno_dict_entries[offset]) |
+           (uint32_t)pgm_read_word(&steno_dict_entries[offset + 2]) << 16;
+}
+
+/* returns offset of entry or STENO_DICT_EMPTY */
+static uint16_t lookup(uint32_t c)
+{
+    uint16_t mask = pgm_read_word(&steno_dict_size) - 1;
+    uint16_t i = steno_hash(c) & mask;
+    for (uint16_t n = 0; n <= mask; n++, i = (i + 1) & mask) {
+        uint16_t offset = pgm_read_word(&steno_dict_slots[i]);
+        if (offset == STENO_DICT_EMPTY) break;
+        if (get32(offset) == c) return offset;
+    }
+    return STENO_DICT_EMPTY;
+}
+
+static void stroke(uint32_t c)
+{
+    uint16_t offset = lookup(c);
+    if (offset == STENO_DICT_EMPTY) {
+        dprintf("steno: %08lX not found\n", c);
+        return;
+    }
+    if (queue_count == STENO_QUEUE_SIZE) {
+        dprintf("steno: queue full\n");
+        return;
+    }
+    uint8_t len = pgm_read_byte(&steno_dict_entries[offset + 4]);
+    if (!len) return;
+    uint8_t i = (queue_head + queue_count) % STENO_QUEUE_SIZE;
+    queue[i].offset = offset + 5;
+    queue[i].len = len;
+    queue_count++;
+}
+
+void steno_key(uint8_t bit, bool pressed)
+{
+    uint32_t b = 1UL<<(bit & 0x1F);
+    if (pressed) {
+        chord |= b;
+        chord_down |= b;
+        return;
+    }
+    chord_down &= ~b;
+    if (!chord_down && chord) {
+        stroke(chord);
+        chord = 0;
+    }
+}
+
+bool steno_busy(void)
+{
+    return queue_count || cur_key || cur_shift;
+}
+
+
+static void set_shift(bool shift)
+{
+    if (shift) {
+        add_weak_mods(MOD_BIT(KC_LSHIFT));
+    } else {
+        del_weak_mods(MOD_BIT(KC_LSHIFT));
+    }
+    cur_shift = shift;
+}
+
+/* next character of queue */
+static void advance(void)
+{
+    if (!--queue[queue_head].len) {
+        queue_head = (queue_head + 1) % STENO_QUEUE_SIZE;
+        queue_count--;
+    } else {
+        queue[queue_head].offset++;
+    }
+}
+
+/* sends at most one report per STENO_REPORT_INTERVAL */
+void steno_task(void)
+{
+    if (!steno_busy()) return;
+    if (timer_elapsed(last_report) < STENO_REPORT_INTERVAL) return;
+
+    // skip characters which can't be typed
+    uint8_t k = 0;
+    while (queue_count) {
+        k = char_to_key(pgm_read_byte(&steno_dict_entries[queue[queue_head].offset]));
+        if (k) break;
+        advance();
+    }
+
+    if (!k) {
+        // all typed; release last key and Shift
+        if (cur_key) del_key(cur_key);
+        cur_key = 0;
+        set_shift(false);
+    } else if ((k & 0x7F) == cur_key || (bool)(k & 0x80) != cur_shift) {
+        // the same key again or Shift changes: release first
+        if (cur_key) del_key(cur_key);
+        cur_key = 0;
+        set_shift(k & 0x80);
+    } else {
+        if (cur_key) del_key(cur_key);
+        cur_key = k & 0x7F;
+        add_key(cur_key);
+        advance();
+    }
+    send_keyboard_report();
+    last_report = timer_read();
+}
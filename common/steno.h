@@ -0,0 +1,82 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef STENO_H
+#define STENO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*
+ * Steno: chord of keys writes a word from dictionary
+ *
+ * Steno keys(ACTION_STENO(bit)) add their bit to chord while pressed and
+ * the chord is looked up when all of them are released. Dictionary is a
+ * hash table in flash generated by tool/steno:
+ *     steno_dict_slots[]:   offset of entry or STENO_DICT_EMPTY, linear probing
+ *     steno_dict_entries[]: chord(4, little endian), length, text...
+ *
+ * Text is typed by steno_task() one report per STENO_REPORT_INTERVAL so
+ * that host polling doesn't drop any and matrix scan goes on meanwhile.
+ * Key of previous character is released in the same report which presses
+ * the next one; extra report is needed only when the same key comes again
+ * or Shift changes.
+ */
+#ifndef STENO_REPORT_INTERVAL
+#   ifdef USB_LOW_LATENCY_ENABLE
+#   define STENO_REPORT_INTERVAL    1
+#   else
+#   define STENO_REPORT_INTERVAL    10
+#   endif
+#endif
+#ifndef STENO_QUEUE_SIZE
+#define STENO_QUEUE_SIZE    4       /* words waiting to be typed */
+#endif
+
+#define STENO_DICT_EMPTY    0xFFFF
+
+/* shared with tool/steno; chords differ in few bits so mix well, it runs once a stroke */
+static inline uint16_t steno_hash(uint32_t chord)
+{
+    chord ^= chord >> 16;
+    chord *= 0x85EBCA6BUL;
+    chord ^= chord >> 13;
+    chord *= 0xC2B2AE35UL;
+    chord ^= chord >> 16;
+    return chord;
+}
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* generated by tool/steno */
+extern const uint16_t steno_dict_size;      /* number of slots, power of 2 */
+extern const uint16_t steno_dict_slots[];
+extern const uint8_t steno_dict_entries[];
+
+void steno_key(uint8_t bit, bool pressed);
+void steno_task(void);
+/* true while text is being typed */
+bool steno_busy(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,5 +9,7 @@ void suspend_idle(uint8_t timeout);
 void suspend_power_down(void);
 bool suspend_wakeup_condition(void);
 void suspend_wakeup_init(void);
+void suspend_wakeup_event(void);
+uint16_t suspend_wakeup_latency(void);
 
 #endif
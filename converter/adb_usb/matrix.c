@@ -25,7 +25,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "util.h"
 #include "debug.h"
+#include "timer.h"
 #include "adb.h"
+#include "sequencer.h"
 #include "matrix.h"
 
 
@@ -64,16 +66,27 @@ uint8_t matrix_cols(void)
     return MATRIX_COLS;
 }
 
-void matrix_init(void)
+static void adb_enable_lr_mods(void)
 {
-    adb_host_init();
-    // wait for keyboard to boot up and receive command
-    _delay_ms(1000);
     // Enable keyboard left/right modifier distinction
     // Addr:Keyboard(0010), Cmd:Listen(10), Register3(11)
     // upper byte: reserved bits 0000, device address 0010
     // lower byte: device handler 00000011
     adb_host_listen(0x2B,0x02,0x03);
+}
+
+static const seq_step_t init_steps[] = {
+    /* action               delay   response    expect  timeout retry */
+    { NULL,                 1000,   NULL,       0,      0,      0 },    // keyboard boots up
+    { adb_enable_lr_mods,   0,      NULL,       0,      0,      0 },
+};
+static sequencer_t init = SEQUENCER(init_steps, 0);
+
+void matrix_init(void)
+{
+    adb_host_init();
+    // keyboard is set up in matrix_scan() without blocking USB enumeration
+    sequencer_start(&init, 0);
 
     // initialize matrix state: all keys off
     for (uint8_t i=0; i < MATRIX_ROWS; i++) matrix[i] = 0x00;
@@ -98,14 +111,20 @@ uint8_t matrix_scan(void)
     uint16_t codes;
     uint8_t key0, key1;
 
+    static uint16_t last_poll = 0;
+
     is_modified = false;
 
+    if (sequencer_task(&init)) return 0;
+
     codes = extra_key;
     extra_key = 0xFFFF;
 
     if ( codes == 0xFFFF )
     {
-        _delay_ms(12);  // delay for preventing overload of poor ADB keyboard controller
+        // interval for preventing overload of poor ADB keyboard controller
+        if (timer_elapsed(last_poll) < 12) return 0;
+        last_poll = timer_read();
         codes = adb_host_kbd_recv();
     }
     key0 = codes>>8;
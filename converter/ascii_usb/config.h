@@ -30,6 +30,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MATRIX_ROWS     16
 #define MATRIX_COLS     16
 
+/* interval between keyboard reports(ms); polling interval of keyboard endpoint */
+#define TYPE_INTERVAL   10
+
 /* key combination for command */
 #define IS_COMMAND()    ( \
     host_get_first_key() == KC_BRK \
@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debug.h"
 #include "action_util.h"
+#include "timer.h"
 #include "protocol/serial.h"
 
 
@@ -66,28 +67,6 @@ void matrix_init(void)
     return;
 }
 
-static void type_key(uint16_t keycode)
-{
-    if (keycode == 0) return;
-
-    uint8_t mods = keycode>>8;
-    uint8_t key = keycode&0xFF;
-    if (mods) {
-        add_mods(mods);
-        send_keyboard_report();
-    }
-
-    add_key(key);
-    send_keyboard_report();
-
-    del_key(key);
-    send_keyboard_report();
-
-    if (mods) {
-        del_mods(mods);
-        send_keyboard_report();
-    }
-}
 static uint16_t code2key(uint8_t code)
 {
     // ASCII to key combination in US laout
@@ -149,21 +128,71 @@ static uint16_t code2key(uint8_t code)
     return 0;
 }
 
+/*
+ * Typing engine
+ *
+ * Characters are taken from serial RX buffer one at a time and typed with as
+ * few reports as possible, at most one report per TYPE_INTERVAL:
+ *   - key of next character replaces held key in one report
+ *   - key is released first only when next character reuses it
+ *   - modifiers(Shift) are held across a run of characters which need them,
+ *     and changed in a report without key
+ *   - all keys and modifiers are released when buffer runs dry
+ */
+static uint16_t type_next = 0;      // keycode waiting to be typed
+static uint8_t type_held = 0;       // key being pressed
+static uint16_t type_last = 0;      // time of last report
+
+static void type_report(void)
+{
+    type_last = timer_read();
+    send_keyboard_report();
+}
+
 uint8_t matrix_scan(void)
 {
-    uint16_t code = serial_recv2();
-    if (code == -1) {
-        return 0;
+    if (!type_next) {
+        int16_t code = serial_recv2();
+        if (code != -1) {
+            print_hex8(code); print(" ");
+
+            // echo back
+            serial_send(code);
+            type_next = code2key(code);
+        }
     }
 
-    print_hex8(code); print(" ");
+    if (timer_elapsed(type_last) < TYPE_INTERVAL) {
+        return 0;
+    }
 
-    // echo back
-    serial_send(code);
-    type_key(code2key(code));
-    
+    if (!type_next) {
+        if (type_held || get_mods()) {
+            type_held = 0;
+            clear_keys();
+            clear_mods();
+            type_report();
+        }
+        return 0;
+    }
 
-    return code;
+    uint8_t mods = type_next>>8;
+    uint8_t key = type_next&0xFF;
+    if (mods != get_mods()) {
+        type_held = 0;
+        clear_keys();
+        set_mods(mods);
+    } else if (key == type_held) {
+        type_held = 0;
+        del_key(key);
+    } else {
+        if (type_held) del_key(type_held);
+        add_key(key);
+        type_held = key;
+        type_next = 0;
+    }
+    type_report();
+    return 1;
 }
 
 inline
@@ -46,10 +46,14 @@ POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "stdint.h"
+#include "stdbool.h"
 #include "led.h"
 
 
+bool next_usb_ready(void);
+
 void led_set(uint8_t usb_led)
 {
-
+    // host may set LEDs on enumeration, before keyboard is initialized
+    if (!next_usb_ready()) return;
 }
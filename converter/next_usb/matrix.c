@@ -56,6 +56,8 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "debug.h"
 #include "matrix.h"
 #include "next_kbd.h"
+#include "timer.h"
+#include "sequencer.h"
 
 static void matrix_make(uint8_t code);
 static void matrix_break(uint8_t code);
@@ -92,17 +94,8 @@ uint8_t matrix_cols(void)
 
 static bool power_state = false;
 
-/* intialize matrix for scanning. should be called once. */
-void matrix_init(void)
+static void next_usb_kbd_init(void)
 {
-#ifdef DEBUG_ON_INIT
-    debug_enable = true;
-#endif
-
-    // I've found that the matrix likes a little while for things to 
-    // settle down before it gets started.  Not sure why :)
-    _delay_ms(250);
-    
     dprintf("[ Intializing NeXT keyboard ]\n");
     NEXT_KBD_LED1_DDR |=  (1<<NEXT_KBD_LED1_BIT);  // LED pin to output
     NEXT_KBD_LED1_ON;
@@ -114,27 +107,64 @@ void matrix_init(void)
     dprintf("Initial power button state: %b\n", power_state);
     
     next_kbd_init();
-
-    // initialize matrix state: all keys off
-    for (uint8_t i=0; i < MATRIX_ROWS; i++) matrix[i] = 0x00;
+}
 
 #ifdef NEXT_KBD_INIT_FLASH_LEDS
-    dprintf("flashing LEDs:");
-    // flash the LEDs after initialization
-    bool leds_on = true;
-    for (uint8_t i = 0; i <= 6; i++)
-    {
-        leds_on = leds_on ? false : true;
-        dprintf(" %b", leds_on); 
-        next_kbd_set_leds(leds_on, leds_on);
-        _delay_ms(250);
-    }
-    dprintf("\n");
+// flash the LEDs after initialization
+static void next_usb_flash_leds(void)
+{
+    static bool leds_on = true;
+    leds_on = leds_on ? false : true;
+    dprintf("flashing LEDs: %b\n", leds_on);
+    next_kbd_set_leds(leds_on, leds_on);
+}
 #endif
 
+static bool kbd_ready = false;
+
+static void next_usb_kbd_ready(void)
+{
     dprintf("[ NeXT keyboard initialized ]\n");
+    kbd_ready = true;
+}
 
-    return;
+/* true when init sequence is done and keyboard can take commands */
+bool next_usb_ready(void)
+{
+    return kbd_ready;
+}
+
+static const seq_step_t init_steps[] = {
+    /* action               delay   response    expect  timeout retry */
+    // I've found that the matrix likes a little while for things to 
+    // settle down before it gets started.  Not sure why :)
+    { NULL,                 250,    NULL,       0,      0,      0 },
+    { next_usb_kbd_init,    0,      NULL,       0,      0,      0 },
+#ifdef NEXT_KBD_INIT_FLASH_LEDS
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+    { next_usb_flash_leds,  250,    NULL,       0,      0,      0 },
+#endif
+    { next_usb_kbd_ready,   0,      NULL,       0,      0,      0 },
+};
+static sequencer_t init = SEQUENCER(init_steps, 0);
+
+/* intialize matrix for scanning. should be called once. */
+void matrix_init(void)
+{
+#ifdef DEBUG_ON_INIT
+    debug_enable = true;
+#endif
+
+    // initialize matrix state: all keys off
+    for (uint8_t i=0; i < MATRIX_ROWS; i++) matrix[i] = 0x00;
+
+    // keyboard is set up in matrix_scan() without blocking USB enumeration
+    sequencer_start(&init, 0);
 }
 
 #define NEXT_KBD_KEYCODE(response)               (uint8_t)((response&0xFF)>>1)
@@ -160,7 +190,12 @@ void matrix_init(void)
 /* scan all key states on matrix */
 uint8_t matrix_scan(void)
 {
-    _delay_ms(20);
+    static uint16_t last_scan = 0;
+
+    if (sequencer_task(&init)) return 0;
+
+    if (timer_elapsed(last_scan) < 20) return 0;
+    last_scan = timer_read();
     
     //next_kbd_set_leds(false, false);
     NEXT_KBD_LED1_OFF;
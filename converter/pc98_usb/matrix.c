@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debug.h"
 #include "protocol/serial.h"
+#include "protocol/sequencer.h"
 
 
 /*
@@ -61,36 +62,41 @@ uint8_t matrix_cols(void)
     return MATRIX_COLS;
 }
 
-static void pc98_inhibit_repeat(void)
+static void pc98_rdy_hi(void)
 {
-    uint8_t code;
+    PC98_RDY_PORT |= (1<<PC98_RDY_BIT);
+}
 
+static void pc98_flush(void)
+{
     while (serial_recv()) ;
-RETRY:
-    PC98_RDY_PORT |= (1<<PC98_RDY_BIT);
-    _delay_ms(500);
-    serial_send(0x9C);
+    pc98_rdy_hi();
+}
 
+static void pc98_send_9c(void)
+{
+    serial_send(0x9C);
     PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
-    _delay_ms(100);
-    while (!(code = serial_recv())) ;
-    print("PC98: send 9C: "); print_hex8(code); print("\n");
-    if (code != 0xFA) goto RETRY;
-
-
+}
 
-    PC98_RDY_PORT |= (1<<PC98_RDY_BIT);
-    _delay_ms(100);
+static void pc98_send_70(void)
+{
     serial_send(0x70);
-
     PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
-    _delay_ms(100);
-    //code = serial_recv();
-    while (!(code = serial_recv())) ;
-    print("PC98: send 70: "); print_hex8(code); print("\n");
-    if (code != 0xFA) goto RETRY;
 }
 
+/* Inhibit repeat: command 9C and 70, each one is ACKed with FA */
+static const seq_step_t inhibit_steps[] = {
+    /* action       delay   response        expect  timeout retry */
+    { NULL,         500,    NULL,           0,      0,      0 },    // power up
+    { pc98_flush,   500,    NULL,           0,      0,      0 },    // INHIBIT_REPEAT
+    { pc98_send_9c, 0,      serial_recv2,   0xFA,   500,    1 },
+    { pc98_rdy_hi,  100,    NULL,           0,      0,      0 },
+    { pc98_send_70, 0,      serial_recv2,   0xFA,   500,    1 },
+};
+#define INHIBIT_REPEAT  1
+static sequencer_t inhibit = SEQUENCER(inhibit_steps, 0);
+
 void matrix_init(void)
 {
     PC98_RST_DDR |= (1<<PC98_RST_BIT);
@@ -112,12 +118,8 @@ void matrix_init(void)
     PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
 */
 
-    _delay_ms(500);
-    pc98_inhibit_repeat();
-
-
-    // PC98 ready
-    PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
+    // PC98 gets ready(RDY low) when the sequence finishes in matrix_scan()
+    sequencer_start(&inhibit, 0);
 
     // initialize matrix state: all keys off
     for (uint8_t i=0; i < MATRIX_ROWS; i++) matrix[i] = 0x00;
@@ -130,42 +132,39 @@ uint8_t matrix_scan(void)
 {
     is_modified = false;
 
-    uint16_t code;
-    PC98_RDY_PORT |= (1<<PC98_RDY_BIT);
-    _delay_us(30);
-    code = serial_recv2();
-    PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
-    if (code == -1) return 0;
-
-if (code == 0x60) {
-    pc98_inhibit_repeat();
-
-/*
-    PC98_RDY_PORT |= (1<<PC98_RDY_BIT);
-    _delay_ms(100);
-    serial_send(0x96);
-    PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
-*/
+    if (sequencer_task(&inhibit)) return 0;
 
-    return 0;
-}
-
-    print_hex8(code); print(" ");
+    // drain bytes until a key changes, keyboard_task() processes a key per scan
+    int16_t code;
+    for (;;) {
+        PC98_RDY_PORT |= (1<<PC98_RDY_BIT);
+        _delay_us(30);
+        code = serial_recv2();
+        PC98_RDY_PORT &= ~(1<<PC98_RDY_BIT);
+        if (code == -1) return 0;
 
-    if (code&0x80) {
-        // break code
-        if (matrix_is_on(ROW(code), COL(code))) {
-            matrix[ROW(code)] &= ~(1<<COL(code));
-            is_modified = true;
+        if (code == 0x60) {
+            sequencer_start(&inhibit, INHIBIT_REPEAT);
+            return 0;
         }
-    } else {
-        // make code
-        if (!matrix_is_on(ROW(code), COL(code))) {
-            matrix[ROW(code)] |=  (1<<COL(code));
-            is_modified = true;
+
+        print_hex8(code); print(" ");
+
+        if (code&0x80) {
+            // break code
+            if (matrix_is_on(ROW(code), COL(code))) {
+                matrix[ROW(code)] &= ~(1<<COL(code));
+                is_modified = true;
+            }
+        } else {
+            // make code
+            if (!matrix_is_on(ROW(code), COL(code))) {
+                matrix[ROW(code)] |=  (1<<COL(code));
+                is_modified = true;
+            }
         }
+        if (is_modified) return code;
     }
-    return code;
 }
 
 bool matrix_is_modified(void)
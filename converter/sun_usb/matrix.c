@@ -47,6 +47,7 @@ static uint8_t matrix[MATRIX_ROWS];
 #define COL(code)      (code&0x07)
 
 static bool is_modified = false;
+static bool waiting_response = false;
 
 
 inline
@@ -79,44 +80,53 @@ uint8_t matrix_scan(void)
 {
     is_modified = false;
 
-    uint8_t code;
-    code = serial_recv();
-    if (!code) return 0;
-
-    debug_hex(code); debug(" ");
-
-    switch (code) {
-        case 0xFF:  // reset success
-        case 0xFE:  // layout
-        case 0x7E:  // reset fail
-            if (code == 0xFF) print("reset: 0xFF ");
-            if (code == 0x7E) print("reset fail: 0x7E ");
-            if (code == 0xFE) print("layout: 0xFE ");
-            // response byte
-            _delay_ms(500);
-            if (code = serial_recv()) print_hex8(code);
-            print("\n");
-            // FALL THROUGH
-        case 0x7F:
-            // all keys up
-            for (uint8_t i=0; i < MATRIX_ROWS; i++) matrix[i] = 0x00;
-            return 0;
+    // response byte following reset or layout
+    if (waiting_response) {
+        int16_t response = serial_response();
+        if (response == SERIAL_WAIT) return 0;
+        if (response != SERIAL_TIMEOUT) print_hex8(response);
+        print("\n");
+        waiting_response = false;
     }
 
-    if (code&0x80) {
-        // break code
-        if (matrix_is_on(ROW(code), COL(code))) {
-            matrix[ROW(code)] &= ~(1<<COL(code));
-            is_modified = true;
+    // drain bytes until a key changes, keyboard_task() processes a key per scan
+    uint8_t code;
+    while ((code = serial_recv())) {
+        debug_hex(code); debug(" ");
+
+        switch (code) {
+            case 0xFF:  // reset success
+            case 0xFE:  // layout
+            case 0x7E:  // reset fail
+                if (code == 0xFF) print("reset: 0xFF ");
+                if (code == 0x7E) print("reset fail: 0x7E ");
+                if (code == 0xFE) print("layout: 0xFE ");
+                // response byte
+                serial_expect(500);
+                waiting_response = true;
+                // FALL THROUGH
+            case 0x7F:
+                // all keys up
+                for (uint8_t i=0; i < MATRIX_ROWS; i++) matrix[i] = 0x00;
+                return 0;
         }
-    } else {
-        // make code
-        if (!matrix_is_on(ROW(code), COL(code))) {
-            matrix[ROW(code)] |=  (1<<COL(code));
-            is_modified = true;
+
+        if (code&0x80) {
+            // break code
+            if (matrix_is_on(ROW(code), COL(code))) {
+                matrix[ROW(code)] &= ~(1<<COL(code));
+                is_modified = true;
+            }
+        } else {
+            // make code
+            if (!matrix_is_on(ROW(code), COL(code))) {
+                matrix[ROW(code)] |=  (1<<COL(code));
+                is_modified = true;
+            }
         }
+        if (is_modified) return code;
     }
-    return code;
+    return 0;
 }
 
 bool matrix_is_modified(void)
@@ -76,27 +76,26 @@ uint8_t matrix_scan(void)
 {
     is_modified = false;
 
-    uint16_t code;
-    code = serial_recv2();
-    if (code == -1) {
-        return 0;
-    }
-
-    dprintf("%02X\n", code);
-    if (code&0x80) {
-        // break code
-        if (matrix_is_on(ROW(code), COL(code))) {
-            matrix[ROW(code)] &= ~(1<<COL(code));
-            is_modified = true;
-        }
-    } else {
-        // make code
-        if (!matrix_is_on(ROW(code), COL(code))) {
-            matrix[ROW(code)] |=  (1<<COL(code));
-            is_modified = true;
+    // drain bytes until a key changes, keyboard_task() processes a key per scan
+    int16_t code;
+    while ((code = serial_recv2()) != -1) {
+        dprintf("%02X\n", code);
+        if (code&0x80) {
+            // break code
+            if (matrix_is_on(ROW(code), COL(code))) {
+                matrix[ROW(code)] &= ~(1<<COL(code));
+                is_modified = true;
+            }
+        } else {
+            // make code
+            if (!matrix_is_on(ROW(code), COL(code))) {
+                matrix[ROW(code)] |=  (1<<COL(code));
+                is_modified = true;
+            }
         }
+        if (is_modified) return code;
     }
-    return code;
+    return 0;
 }
 
 bool matrix_is_modified(void)
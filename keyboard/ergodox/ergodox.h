@@ -59,6 +59,22 @@ uint8_t ergodox_left_leds_update(void);
 #define LEFT_LED_2_SHIFT        6       // in MCP23018 port B
 #define LEFT_LED_3_SHIFT        7       // in MCP23018 port A
 
+// layer indicator bits(see common/indicator.h)
+#define INDICATOR_BOARD         (1<<0)
+#define INDICATOR_LEFT_1        (1<<1)  // left top
+#define INDICATOR_LEFT_2        (1<<2)  // left middle
+#define INDICATOR_LEFT_3        (1<<3)  // left bottom
+#define INDICATOR_LEFT_ALL      (INDICATOR_LEFT_1 | INDICATOR_LEFT_2 | INDICATOR_LEFT_3)
+
+// LEDs driven by layer indicator of the keymap; others are left alone
+#if defined(KEYMAP_CUB)
+#define INDICATOR_LEDS          (INDICATOR_BOARD | INDICATOR_LEFT_ALL)
+#elif defined(KEYMAP_TSCHULTE)
+#define INDICATOR_LEDS          INDICATOR_BOARD
+#else
+#define INDICATOR_LEDS          0
+#endif
+
 extern bool ergodox_left_led_1;         // left top
 extern bool ergodox_left_led_2;         // left middle
 extern bool ergodox_left_led_3;         // left bottom
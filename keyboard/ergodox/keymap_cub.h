@@ -555,6 +555,25 @@ const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt) {
     return MACRO_NONE;
 }
 
+/*
+ * layer indicators: white(left 1), blue(left 2), green(left 3) and board LED
+ */
+uint8_t indicator_layer(uint32_t state, uint32_t default_state)
+{
+    switch (biton32(state)) {
+        case 1:  return INDICATOR_LEFT_1 | INDICATOR_LEFT_2 | INDICATOR_LEFT_3;    // all
+        case 2:  return INDICATOR_LEFT_2;                       // blue
+        case 3:  return INDICATOR_LEFT_3;                       // green
+        case 8:  return INDICATOR_LEFT_2 | INDICATOR_LEFT_3;    // blue and green
+        case 4:
+        case 5:
+        case 7:  return INDICATOR_LEFT_1;                       // white
+        case 6:  return INDICATOR_LEFT_1 | INDICATOR_BOARD;     // white and board
+        case 9:  return INDICATOR_LEFT_1 | INDICATOR_LEFT_3;    // white and green
+        default: return 0;                                      // none
+    }
+}
+
 #define FN_ACTIONS_SIZE     (sizeof(fn_actions)   / sizeof(fn_actions[0]))
 #define FN_ACTIONS_4_SIZE   (sizeof(fn_actions_4) / sizeof(fn_actions_4[0]))
 #define FN_ACTIONS_7_SIZE   (sizeof(fn_actions_7) / sizeof(fn_actions_7[0]))
@@ -567,6 +567,20 @@ const macro_t *action_get_macro(keyrecord_t *record, uint8_t id, uint8_t opt) {
 }
 
 
+/*
+ * layer indicator: board LED on layer 1 and 6
+ */
+uint8_t indicator_layer(uint32_t state, uint32_t default_state)
+{
+    switch (biton32(state)) {
+        case 1:
+        case 6:
+            return INDICATOR_BOARD;
+        default:
+            return 0;
+    }
+}
+
 #define FN_ACTIONS_SIZE     (sizeof(fn_actions)   / sizeof(fn_actions[0]))
 #define FN_ACTIONS_0_SIZE   (sizeof(fn_actions_0) / sizeof(fn_actions_0[0]))
 #define FN_ACTIONS_1_SIZE   (sizeof(fn_actions_1) / sizeof(fn_actions_1[0]))
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 #include "led.h"
+#include "indicator.h"
 #include "ergodox.h"
 
 
@@ -55,3 +56,18 @@ void led_set(uint8_t usb_led)
     }
 }
 
+#ifdef INDICATOR_ENABLE
+void indicator_write(uint8_t bits)
+{
+    if (INDICATOR_LEDS & INDICATOR_BOARD) {
+        if (bits & INDICATOR_BOARD)  ergodox_board_led_on();  else ergodox_board_led_off();
+    }
+    if (INDICATOR_LEDS & INDICATOR_LEFT_ALL) {
+        if (bits & INDICATOR_LEFT_1) ergodox_left_led_1_on(); else ergodox_left_led_1_off();
+        if (bits & INDICATOR_LEFT_2) ergodox_left_led_2_on(); else ergodox_left_led_2_off();
+        if (bits & INDICATOR_LEFT_3) ergodox_left_led_3_on(); else ergodox_left_led_3_off();
+
+        mcp23018_status = ergodox_left_leds_update();
+    }
+}
+#endif
@@ -22,7 +22,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stdbool.h>
 #include <avr/io.h>
 #include <util/delay.h>
-#include "action_layer.h"
+#include "indicator.h"
 #include "print.h"
 #include "debug.h"
 #include "util.h"
@@ -100,6 +100,7 @@ uint8_t matrix_scan(void)
             } else {
                 print("left side attached\n");
                 ergodox_blink_all_leds();
+                indicator_refresh();
             }
         }
     }
@@ -118,68 +119,6 @@ uint8_t matrix_scan(void)
     }
 #endif
 
-#ifdef KEYMAP_CUB
-    uint8_t layer = biton32(layer_state);
-
-    ergodox_board_led_off();
-    ergodox_left_led_1_off();
-    ergodox_left_led_2_off();
-    ergodox_left_led_3_off();
-    switch (layer) {
-        case 1:
-            // all
-            ergodox_left_led_1_on();
-            ergodox_left_led_2_on();
-            ergodox_left_led_3_on();
-            break;
-        case 2:
-            // blue
-            ergodox_left_led_2_on();
-            break;
-        case 8:
-            // blue and green
-            ergodox_left_led_2_on();
-            // break missed intentionally
-        case 3:
-            // green
-            ergodox_left_led_3_on();
-            break;
-        case 6:
-            ergodox_board_led_on();
-            // break missed intentionally
-        case 4:
-        case 5:
-        case 7:
-            // white
-            ergodox_left_led_1_on();
-            break;
-        case 9:
-            // white+green
-            ergodox_left_led_1_on();
-            ergodox_left_led_3_on();
-            break;
-        default:
-            // none
-            break;
-    }
-
-    mcp23018_status = ergodox_left_leds_update();
-#endif
-
-#ifdef KEYMAP_TSCHULTE
-    uint8_t layer = biton32(layer_state);
-
-    switch (layer) {
-        case 1:
-        case 6:
-            ergodox_board_led_on();
-            break;
-        default:
-            ergodox_board_led_off();
-            break;
-    }
-#endif
-
     for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
         select_row(i);
         matrix_row_t cols = read_cols(i);
@@ -1,5 +1,8 @@
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
+#include "timer.h"
 #include "battery.h"
 
 
@@ -18,8 +21,10 @@ void battery_init(void)
 
     // ADC setting for voltage monitor
     // Ref:2.56V band-gap, Input:ADC0(PF0), Prescale:128(16MHz/128=125KHz)
+    // Trigger:free running
     ADMUX = (1<<REFS1) | (1<<REFS0);
     ADCSRA = (1<<ADPS2) | (1<<ADPS1) | (1<<ADPS0);
+    ADCSRB = 0;
     // digital input buffer disable(24.9.5)
     DIDR0 = (1<<ADC0D) | (1<<ADC4D) | (1<<ADC7D);
     DIDR1 = (1<<AIN0D);
@@ -30,9 +35,31 @@ void battery_init(void)
     PORTF &= ~(1<<4);
 }
 
+/* LED(PF5) state saved while PF5 reads charger status */
+static bool led_saved = false;
+static uint8_t led_ddr, led_port;
+
 // Indicator for battery
 void battery_led(battery_led_t val)
 {
+    if (led_saved) {
+        // change saved state, which is restored after charger status is read
+        if (val == LED_TOGGLE) {
+            led_ddr  |=  (1<<5);
+            led_port ^=  (1<<5);
+        } else if (val == LED_ON) {
+            led_ddr  |=  (1<<5);
+            led_port &= ~(1<<5);
+        } else if (val == LED_OFF) {
+            led_ddr  |=  (1<<5);
+            led_port |=  (1<<5);
+        } else {
+            led_ddr  &= ~(1<<5);
+            led_port &= ~(1<<5);
+        }
+        return;
+    }
+
     if (val == LED_TOGGLE) {
         // Toggle LED
         DDRF  |=  (1<<5);
@@ -52,64 +79,139 @@ void battery_led(battery_led_t val)
     }
 }
 
+/*
+ * Sampler
+ *
+ * Every BATTERY_SAMPLE_INTERVAL battery_task() turns on voltage divider and
+ * ADC, and pulls up charger status pin. After they settle it reads charger
+ * status and starts ADC in free running mode. ADC interrupt accumulates
+ * BATTERY_ADC_SAMPLES conversions and turns off ADC and divider by itself.
+ * Then the average is added to moving average. Nothing waits for ADC.
+ */
+enum {
+    SAMPLE_IDLE,
+    SAMPLE_SETTLE,
+    SAMPLE_CONVERT,
+};
+static uint8_t sample_state = SAMPLE_IDLE;
+static uint16_t sample_timer = 0;
+
+static volatile uint8_t adc_count = 0;
+static volatile uint16_t adc_sum = 0;
+
+static uint16_t adc_ema = 0;    // ADC value * 8
+static bool charging = false;
+
+ISR(ADC_vect)
+{
+    uint16_t v = ADC;
+    // first conversion after enabling ADC is not accurate
+    if (adc_count++ == 0) return;
+    adc_sum += v;
+    if (adc_count > BATTERY_ADC_SAMPLES) {
+        ADCSRA &= ~((1<<ADEN) | (1<<ADATE) | (1<<ADIE));
+        // ADC disable voltate divider(PF4)
+        PORTF &= ~(1<<4);
+    }
+}
+
+void battery_task(void)
+{
+    switch (sample_state) {
+        case SAMPLE_IDLE:
+            if (timer_elapsed(sample_timer) < BATTERY_SAMPLE_INTERVAL) return;
+            sample_timer = timer_read();
+
+            // ADC enable voltate divider(PF4)
+            DDRF  |=  (1<<4);
+            PORTF |=  (1<<4);
+            ADCSRA |= (1<<ADEN);    // charging S/H capacitance
+
+            // Charger status: input with pullup
+            led_ddr  = DDRF;
+            led_port = PORTF;
+            led_saved = true;
+            DDRF  &= ~(1<<5);
+            PORTF |=  (1<<5);
+
+            sample_state = SAMPLE_SETTLE;
+            break;
+        case SAMPLE_SETTLE:
+            if (timer_elapsed(sample_timer) < 2) return;
+
+            // Charger Status:
+            //   MCP73831   MCP73832   LTC4054  Status
+            //   Hi-Z       Hi-Z       Hi-Z     Shutdown/No Battery
+            //   Low        Low        Low      Charging
+            //   Hi         Hi-Z       Hi-Z     Charged
+            charging = (USBSTA&(1<<VBUS)) && !(PINF&(1<<5));
+            // TODO: With MCP73831 this can not get stable status when charging.
+            // LED is powered from PSEL line(USB or Lipo)
+            // due to weak low output of STAT pin?
+            // due to pull-up'd via resitor and LED?
+
+            // restore last register status
+            DDRF  = (DDRF&~(1<<5))  | (led_ddr&(1<<5));
+            PORTF = (PORTF&~(1<<5)) | (led_port&(1<<5));
+            led_saved = false;
+
+            adc_count = 0;
+            adc_sum = 0;
+            ADCSRA |= (1<<ADATE) | (1<<ADIE) | (1<<ADSC);
+            sample_state = SAMPLE_CONVERT;
+            break;
+        case SAMPLE_CONVERT:
+            if (ADCSRA & (1<<ADEN)) return;
+            {
+                uint16_t avg = adc_sum / BATTERY_ADC_SAMPLES;
+                // moving average: ema += (avg - ema)/8
+                adc_ema = adc_ema ? adc_ema - (adc_ema>>3) + avg : avg<<3;
+            }
+            sample_state = SAMPLE_IDLE;
+            break;
+    }
+}
+
 bool battery_charging(void)
 {
     if (!(USBSTA&(1<<VBUS))) return false;
-
-    // Charger Status:
-    //   MCP73831   MCP73832   LTC4054  Status
-    //   Hi-Z       Hi-Z       Hi-Z     Shutdown/No Battery
-    //   Low        Low        Low      Charging
-    //   Hi         Hi-Z       Hi-Z     Charged
-
-    // preserve last register status
-    uint8_t ddrf_prev  = DDRF;
-    uint8_t portf_prev = PORTF;
-
-    // Input with pullup
-    DDRF  &= ~(1<<5);
-    PORTF |=  (1<<5);
-    _delay_ms(1);
-    bool charging = PINF&(1<<5) ? false : true;
-
-    // restore last register status
-    DDRF  = (DDRF&~(1<<5))  | (ddrf_prev&(1<<5));
-    PORTF = (PORTF&~(1<<5)) | (portf_prev&(1<<5));
-
-    // TODO: With MCP73831 this can not get stable status when charging.
-    // LED is powered from PSEL line(USB or Lipo)
-    // due to weak low output of STAT pin?
-    // due to pull-up'd via resitor and LED?
     return charging;
 }
 
-// Returns voltage in mV
+// Returns voltage in mV, 0 until first sample
 uint16_t battery_voltage(void)
 {
-    // ADC disable voltate divider(PF4)
-    DDRF  |=  (1<<4);
-    PORTF |=  (1<<4);
-
-    volatile uint16_t bat;
-    ADCSRA |= (1<<ADEN);
-    _delay_ms(1);   // wait for charging S/H capacitance
-
-    ADCSRA |= (1<<ADSC);
-    while (ADCSRA & (1<<ADSC)) ;
-    bat = ADC;
-
-    ADCSRA &= ~(1<<ADEN);
+    if (!adc_ema) return 0;
+    return (((adc_ema + 4)>>3) - BATTERY_ADC_OFFSET) * BATTERY_ADC_RESOLUTION;
+}
 
-    // ADC disable voltate divider(PF4)
-    DDRF  |=  (1<<4);
-    PORTF &= ~(1<<4);
+/* Li-Po discharge curve: voltage(mV) of level 100%, 90%, ... 0% */
+static const uint16_t PROGMEM level_voltage[] = {
+    4200, 4100, 4000, 3920, 3850, 3800, 3760, 3730, 3700, 3600, 3500
+};
 
-    return (bat - BATTERY_ADC_OFFSET) * BATTERY_ADC_RESOLUTION;
+// Returns state of charge estimated from voltage in %
+uint8_t battery_level(void)
+{
+    uint16_t v = battery_voltage();
+    if (!v) return 0;
+    uint16_t hi = pgm_read_word(&level_voltage[0]);
+    if (v >= hi) return 100;
+    for (uint8_t i = 1; i < sizeof(level_voltage)/sizeof(level_voltage[0]); i++) {
+        uint16_t lo = pgm_read_word(&level_voltage[i]);
+        if (v >= lo) {
+            // interpolate in 10% step
+            return (10 - i) * 10 + (uint32_t)(v - lo) * 10 / (hi - lo);
+        }
+        hi = lo;
+    }
+    return 0;
 }
 
 static bool low_voltage(void) {
     static bool low = false;
     uint16_t v = battery_voltage();
+    if (!v) return low;
     if (v < BATTERY_VOLTAGE_LOW_LIMIT) {
         low = true;
     } else if (v > BATTERY_VOLTAGE_LOW_RECOVERY) {
@@ -21,9 +21,11 @@ typedef enum {
 
 /* Battery API */
 void battery_init(void);
+void battery_task(void);
 void battery_led(battery_led_t val);
 bool battery_charging(void);
 uint16_t battery_voltage(void);
+uint8_t battery_level(void);
 battery_status_t battery_status(void);
 
 #define BATTERY_VOLTAGE_LOW_LIMIT       3500
@@ -31,5 +33,8 @@ battery_status_t battery_status(void);
 // ADC offset:16, resolution:5mV
 #define BATTERY_ADC_OFFSET              16
 #define BATTERY_ADC_RESOLUTION          5
+// sampling period(ms) and conversions averaged per sample
+#define BATTERY_SAMPLE_INTERVAL         1000
+#define BATTERY_ADC_SAMPLES             8
 
 #endif
@@ -3,6 +3,7 @@
 #include "host_driver.h"
 #include "serial.h"
 #include "rn42.h"
+#include "bt_report.h"
 #include "print.h"
 #include "timer.h"
 #include "wait.h"
@@ -135,6 +136,16 @@ static uint8_t keyboard_leds(void) { return leds; }
 void rn42_set_leds(uint8_t l) { leds = l; }
 
 static void send_keyboard(report_keyboard_t *report)
+{
+    bt_report_keyboard(report);
+}
+
+bool bt_report_ready(void)
+{
+    return !rn42_rts();
+}
+
+void bt_report_send_keyboard(report_keyboard_t *report)
 {
     // wake from deep sleep
 /*
@@ -158,6 +169,7 @@ static void send_keyboard(report_keyboard_t *report)
 
 static void send_mouse(report_mouse_t *report)
 {
+    bt_report_flush();  // keep order with queued keyboard reports
     // wake from deep sleep
 /*
     PORTD |= (1<<5);    // high
@@ -206,6 +218,7 @@ static uint16_t usage2bits(uint16_t usage)
 
 static void send_consumer(uint16_t data)
 {
+    bt_report_flush();  // keep order with queued keyboard reports
     uint16_t bits = usage2bits(data);
     serial_send(0xFD);  // Raw report mode
     serial_send(3);     // length
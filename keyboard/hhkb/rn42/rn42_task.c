@@ -15,6 +15,16 @@
 #include "wait.h"
 #include "command.h"
 #include "battery.h"
+#include "bt_report.h"
+
+/* RTS must stay for this time(ms) before switching driver */
+#ifndef RN42_SWITCH_DEBOUNCE
+#define RN42_SWITCH_DEBOUNCE    50
+#endif
+/* reports go to USB also for this time(ms) after switching to RN-42 */
+#ifndef RN42_HANDOVER_OVERLAP
+#define RN42_HANDOVER_OVERLAP   500
+#endif
 
 static bool config_mode = false;
 static bool force_usb = false;
@@ -71,15 +81,29 @@ void rn42_task(void)
 
     /* Bluetooth mode when ready */
     if (!config_mode && !force_usb) {
-        if (!rn42_rts() && host_get_driver() != &rn42_driver) {
-            clear_keyboard();
-            host_set_driver(&rn42_driver);
-        } else if (rn42_rts() && host_get_driver() != &lufa_driver) {
-            clear_keyboard();
-            host_set_driver(&lufa_driver);
+        // switch when RTS stays for RN42_SWITCH_DEBOUNCE ms
+        static uint16_t rts_timer = 0;
+        host_driver_t *want = rn42_rts() ? &lufa_driver : &rn42_driver;
+        if (want == host_get_driver()) {
+            rts_timer = timer_read();
+        } else if (timer_elapsed(rts_timer) >= RN42_SWITCH_DEBOUNCE) {
+            if (want == &rn42_driver) {
+                // USB may still be connected; keep it fed until link settles
+                host_handover(&rn42_driver, RN42_HANDOVER_OVERLAP);
+            } else {
+                host_handover(&lufa_driver, 0);
+                bt_report_clear();  // module is off
+            }
+            // time since RTS changed including debounce
+            dprintf("switch: %s %ums\n", (want == &rn42_driver) ? "RN-42" : "LUFA",
+                    timer_elapsed(rts_timer));
         }
     }
 
+    bt_report_task();
+
+
+    battery_task();
 
     static uint16_t prev_timer = 0;
     uint16_t e = timer_elapsed(prev_timer);
@@ -96,8 +120,10 @@ void rn42_task(void)
         }
 
         /* every minute */
+        static uint32_t prev_minute = 0;
         uint32_t t = timer_read32()/1000;
-        if (t%60 == 0) {
+        if (t/60 != prev_minute) {
+            prev_minute = t/60;
             uint16_t v = battery_voltage();
             uint8_t h = t/3600;
             uint8_t m = t%3600/60;
@@ -163,6 +189,7 @@ static void enter_command_mode(void)
 {
     prev_driver = host_get_driver();
     clear_keyboard();
+    bt_report_flush();
     host_set_driver(&rn42_config_driver);   // null driver; not to send a key to host
     rn42_disconnect();
     while (rn42_linked()) ;
@@ -321,6 +348,7 @@ bool command_extra(uint8_t code)
         case KC_I:
             print("\n----- RN-42 info -----\n");
             xprintf("protocol: %s\n", (host_get_driver() == &rn42_driver) ? "RN-42" : "LUFA");
+            xprintf("handover: %ums\n", host_handover_time());
             xprintf("force_usb: %X\n", force_usb);
             xprintf("rn42: %s\n", rn42_rts() ? "OFF" : (rn42_linked() ? "CONN" : "ON"));
             xprintf("rn42_autoconnecting(): %X\n", rn42_autoconnecting());
@@ -360,7 +388,7 @@ bool command_extra(uint8_t code)
             // battery monitor
             t = timer_read32()/1000;
             b = battery_voltage();
-            xprintf("BAT: %umV\t", b);
+            xprintf("BAT: %umV %u%%\t", b, battery_level());
             xprintf("%02u:",   t/3600);
             xprintf("%02u:",   t%3600/60);
             xprintf("%02u\n",  t%60);
@@ -374,6 +402,7 @@ bool command_extra(uint8_t code)
                 print("USB mode\n");
                 force_usb = true;
                 clear_keyboard();
+                bt_report_flush();
                 host_set_driver(&lufa_driver);
             }
             return true;
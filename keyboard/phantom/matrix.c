@@ -11,11 +11,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <util/delay.h>
 #include "print.h"
 #include "debug.h"
 #include "util.h"
 #include "matrix.h"
+#include "suspend.h"
 
 
 #ifndef DEBOUNCE
@@ -160,6 +162,38 @@ uint8_t matrix_key_count(void)
     return count;
 }
 
+/* Wake on key press during suspend
+ * All columns are driven low and rows(PCINT0-5) wake MCU on change.
+ */
+bool matrix_wakeup_enable(void)
+{
+    DDRC  |= 0b11000000;
+    PORTC &= ~0b11000000;
+    DDRD  |= 0b11111111;
+    PORTD &= ~0b11111111;
+    DDRE  |= 0b01000000;
+    PORTE &= ~0b01000000;
+    DDRF  |= 0b11110011;
+    PORTF &= ~0b11110011;
+
+    PCMSK0 |= 0b00111111;
+    PCIFR = (1<<PCIF0);
+    PCICR |= (1<<PCIE0);
+    return true;
+}
+
+void matrix_wakeup_disable(void)
+{
+    PCICR &= ~(1<<PCIE0);
+    PCMSK0 &= ~0b00111111;
+    unselect_cols();
+}
+
+ISR(PCINT0_vect)
+{
+    suspend_wakeup_event();
+}
+
 /* Row pin configuration
  * row: 0   1   2   3   4   5
  * pin: B5  B4  B3  B2  B1  B0
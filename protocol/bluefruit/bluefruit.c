@@ -99,7 +99,7 @@ static void send_keyboard(report_keyboard_t *report)
     bluefruit_trace_header();
 #endif
     bluefruit_serial_send(0xFD);
-    for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_BOOT_SIZE; i++) {
         bluefruit_serial_send(report->raw[i]);
     }
 #ifdef BLUEFRUIT_TRACE_SERIAL   
@@ -0,0 +1,162 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "timer.h"
+#include "debug.h"
+#include "bt_report.h"
+
+
+typedef struct {
+    uint8_t mods;
+    uint8_t keys[6];
+} bt_keyboard_t;
+
+#define BT_KEYS     6
+
+static bt_keyboard_t queue[BT_REPORT_QUEUE_SIZE];
+static uint8_t queue_head = 0;
+static uint8_t queue_count = 0;
+static bt_keyboard_t sent;
+static uint16_t sent_time = 0;
+static uint8_t interval = BT_REPORT_INTERVAL;
+static uint8_t ready_count = 0;
+
+#define QUEUE_INDEX(i)  ((queue_head + (i)) % BT_REPORT_QUEUE_SIZE)
+
+
+__attribute__ ((weak))
+bool bt_report_ready(void)
+{
+    return true;
+}
+
+static bool has_key(const bt_keyboard_t *r, uint8_t key)
+{
+    for (uint8_t i = 0; i < BT_KEYS; i++) {
+        if (r->keys[i] == key) return true;
+    }
+    return false;
+}
+
+static bool keys_differ(const bt_keyboard_t *a, const bt_keyboard_t *b)
+{
+    for (uint8_t i = 0; i < BT_KEYS; i++) {
+        if (a->keys[i] && !has_key(b, a->keys[i])) return true;
+        if (b->keys[i] && !has_key(a, b->keys[i])) return true;
+    }
+    return false;
+}
+
+/* true if 'b' can't be dropped between 'a' and 'c' */
+static bool double_edge(const bt_keyboard_t *a, const bt_keyboard_t *b, const bt_keyboard_t *c)
+{
+    if ((a->mods ^ b->mods) & (b->mods ^ c->mods)) return true;
+    for (uint8_t i = 0; i < BT_KEYS; i++) {
+        uint8_t k = b->keys[i];
+        if (k && !has_key(a, k) && !has_key(c, k)) return true;     // down, up
+        k = a->keys[i];
+        if (k && !has_key(b, k) && has_key(c, k)) return true;      // up, down
+    }
+    // order of key and modifier edges: Shift down, A down, Shift up is not 'a'
+    bool keys_ab = keys_differ(a, b), keys_bc = keys_differ(b, c);
+    bool mods_ab = a->mods != b->mods, mods_bc = b->mods != c->mods;
+    if ((keys_ab && mods_bc) || (mods_ab && keys_bc)) return true;
+    return false;
+}
+
+static void send(void)
+{
+    bt_keyboard_t *r = &queue[queue_head];
+    report_keyboard_t report = {};
+    report.mods = r->mods;
+    memcpy(report.keys, r->keys, BT_KEYS);
+    bt_report_send_keyboard(&report);
+
+    sent = *r;
+    sent_time = timer_read();
+    queue_head = QUEUE_INDEX(1);
+    queue_count--;
+}
+
+void bt_report_keyboard(report_keyboard_t *report)
+{
+    bt_keyboard_t r;
+    r.mods = report->mods;
+    memcpy(r.keys, report->keys, BT_KEYS);
+
+    if (queue_count) {
+        bt_keyboard_t *last = &queue[QUEUE_INDEX(queue_count - 1)];
+        bt_keyboard_t *prev = (queue_count > 1 ? &queue[QUEUE_INDEX(queue_count - 2)] : &sent);
+        if (!double_edge(prev, last, &r)) {
+            *last = r;
+            return;
+        }
+    }
+    if (queue_count == BT_REPORT_QUEUE_SIZE) {
+        // no room: send oldest now rather than lose its edges
+        dprint("bt_report: queue full\n");
+        send();
+    }
+    queue[QUEUE_INDEX(queue_count)] = r;
+    queue_count++;
+
+    bt_report_task();
+}
+
+void bt_report_task(void)
+{
+    if (!queue_count) return;
+    if (timer_elapsed(sent_time) < interval) return;
+
+    if (!bt_report_ready()) {
+        // module is still busy with previous report: link is slower
+        if (interval < BT_REPORT_INTERVAL_MAX) interval++;
+        ready_count = 0;
+        sent_time = timer_read();
+        return;
+    }
+    if (++ready_count == 16 && interval > BT_REPORT_INTERVAL) {
+        interval--;
+        ready_count = 0;
+    }
+    send();
+}
+
+void bt_report_flush(void)
+{
+    while (queue_count) {
+        send();
+    }
+}
+
+bool bt_report_pending(void)
+{
+    return queue_count;
+}
+
+void bt_report_clear(void)
+{
+    queue_count = 0;
+    memset(&sent, 0, sizeof(sent));
+}
+
+uint8_t bt_report_interval(void)
+{
+    return interval;
+}
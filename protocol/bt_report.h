@@ -0,0 +1,67 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef BT_REPORT_H
+#define BT_REPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "report.h"
+
+
+/*
+ * Keyboard report scheduler for Bluetooth modules
+ *
+ * A module can deliver only one report per link connection interval(7.5-15ms)
+ * and queues the rest, so reports written back to back arrive late. Reports
+ * are queued here and sent at most once per interval; a queued report is
+ * replaced with newer one as long as no key goes down and up(or up and down)
+ * in between and keys and modifiers don't change in turn, so every key edge
+ * still reaches the host in order. Mouse and consumer reports are not queued;
+ * drivers flush the queue before sending them so that order with keyboard
+ * reports is kept(e.g. Shift+click).
+ *
+ * Interval starts at BT_REPORT_INTERVAL and grows while the module is not
+ * ready(flow control) when a report is due, then shrinks back as reports go
+ * through. Only boot report part(mods and 6 keys) is kept.
+ */
+#ifndef BT_REPORT_INTERVAL
+#define BT_REPORT_INTERVAL      8
+#endif
+#ifndef BT_REPORT_INTERVAL_MAX
+#define BT_REPORT_INTERVAL_MAX  30
+#endif
+#ifndef BT_REPORT_QUEUE_SIZE
+#define BT_REPORT_QUEUE_SIZE    8
+#endif
+
+
+/* queues report; called from send_keyboard of host driver */
+void bt_report_keyboard(report_keyboard_t *report);
+/* sends queued report when interval has passed; call from main loop */
+void bt_report_task(void);
+/* sends all queued reports at once; before switching to other driver */
+void bt_report_flush(void);
+bool bt_report_pending(void);
+void bt_report_clear(void);
+uint8_t bt_report_interval(void);
+
+/* transport: writes report to module */
+void bt_report_send_keyboard(report_keyboard_t *report);
+/* transport: module can accept report now(weak, default true) */
+bool bt_report_ready(void);
+
+#endif
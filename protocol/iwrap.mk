@@ -5,6 +5,7 @@ OPT_DEFS += -DPROTOCOL_IWRAP
 SRC +=	$(IWRAP_DIR)/main.c \
 	$(IWRAP_DIR)/iwrap.c \
 	$(IWRAP_DIR)/suart.S \
+	protocol/bt_report.c \
 	$(COMMON_DIR)/sendchar_uart.c \
 	$(COMMON_DIR)/uart.c
 
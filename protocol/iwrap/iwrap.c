@@ -35,6 +35,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "report.h"
 #include "host_driver.h"
 #include "iwrap.h"
+#include "bt_report.h"
 #include "print.h"
 
 
@@ -328,6 +329,11 @@ static uint8_t keyboard_leds(void) {
 }
 
 static void send_keyboard(report_keyboard_t *report)
+{
+    bt_report_keyboard(report);
+}
+
+void bt_report_send_keyboard(report_keyboard_t *report)
 {
     if (!iwrap_connected() && !iwrap_check_connection()) return;
     MUX_HEADER(0x01, 0x0c);
@@ -349,6 +355,7 @@ static void send_keyboard(report_keyboard_t *report)
 
 static void send_mouse(report_mouse_t *report)
 {
+    bt_report_flush();  // keep order with queued keyboard reports
 #if defined(MOUSEKEY_ENABLE) || defined(PS2_MOUSE_ENABLE)
     if (!iwrap_connected() && !iwrap_check_connection()) return;
     MUX_HEADER(0x01, 0x09);
@@ -373,6 +380,7 @@ static void send_system(uint16_t data)
 
 static void send_consumer(uint16_t data)
 {
+    bt_report_flush();  // keep order with queued keyboard reports
 #ifdef EXTRAKEY_ENABLE
     static uint16_t last_data = 0;
     uint8_t bits1 = 0;
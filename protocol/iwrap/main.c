@@ -27,6 +27,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "action.h"
 #include "iwrap.h"
+#include "bt_report.h"
 #ifdef PROTOCOL_VUSB
 #   include "vusb.h"
 #   include "usbdrv.h"
@@ -116,6 +117,7 @@ void change_driver(host_driver_t *driver)
     host_send_keyboard_report();
     */
     clear_keyboard();
+    bt_report_flush();
     _delay_ms(1000);
     host_set_driver(driver);
 }
@@ -168,6 +170,7 @@ int main(void)
             usbPoll();
 #endif
         keyboard_task();
+        bt_report_task();
 #ifdef PROTOCOL_VUSB
         if (host_get_driver() == vusb_driver())
             vusb_transfer_keyboard();
@@ -183,7 +186,7 @@ int main(void)
 
         // TODO: suspend.h
         if (host_get_driver() == iwrap_driver()) {
-            if (sleeping && !insomniac) {
+            if (sleeping && !insomniac && !bt_report_pending()) {
                 _delay_ms(1);   // wait for UART to send
                 iwrap_sleep();
                 sleep(WDTO_60MS);
@@ -137,8 +137,14 @@ typedef struct
 
 #ifdef CONSOLE_ENABLE
 #   define CONSOLE_IN_EPNUM         (EXTRAKEY_IN_EPNUM + 1)
-#   define CONSOLE_OUT_EPNUM        (EXTRAKEY_IN_EPNUM + 1)
-//#   define CONSOLE_OUT_EPNUM        (EXTRAKEY_IN_EPNUM + 2)
+#   ifdef HID_COMMAND_ENABLE
+#       define CONSOLE_OUT_EPNUM    (EXTRAKEY_IN_EPNUM + 2)
+#   else
+#       define CONSOLE_OUT_EPNUM    (EXTRAKEY_IN_EPNUM + 1)
+#   endif
+#   if defined(__AVR_ATmega32U2__) && CONSOLE_OUT_EPNUM > 4
+#       error "Endpoints are not available enough to support all functions. Remove some in Makefile.(MOUSEKEY, EXTRAKEY, CONSOLE, HID_COMMAND)"
+#   endif
 #else
 #   define CONSOLE_OUT_EPNUM        EXTRAKEY_IN_EPNUM
 #endif
@@ -151,13 +157,32 @@ typedef struct
 #endif
 
 
-#define KEYBOARD_EPSIZE             8
+#ifdef HYBRID_KRO_ENABLE
+#   define KEYBOARD_EPSIZE          32
+#else
+#   define KEYBOARD_EPSIZE          8
+#endif
 #define MOUSE_EPSIZE                8
 #define EXTRAKEY_EPSIZE             8
 #define CONSOLE_EPSIZE              32
 #define NKRO_EPSIZE                 16
 
 
+/* polling interval(ms) of keyboard, mouse and extrakey endpoints and banks of HID endpoints
+ * Low latency profile polls every 1ms and double-banks the endpoints so that
+ * a report can be queued while the previous one is still waiting for the host.
+ * Host still takes one report a poll; the second bank only keeps the send of
+ * back-to-back reports from blocking main loop(tool/host_test/usb_polling).
+ */
+#ifdef USB_LOW_LATENCY_ENABLE
+#   define USB_POLLING_INTERVAL     1
+#   define USB_HID_BANK             ENDPOINT_BANK_DOUBLE
+#else
+#   define USB_POLLING_INTERVAL     10
+#   define USB_HID_BANK             ENDPOINT_BANK_SINGLE
+#endif
+
+
 uint16_t CALLBACK_USB_GetDescriptor(const uint16_t wValue,
                                     const uint8_t wIndex,
                                     const void** const DescriptorAddress)
@@ -48,10 +48,17 @@
 #include "sleep_led.h"
 #endif
 #include "suspend.h"
+#ifdef HID_COMMAND_ENABLE
+#include "hid_command.h"
+#endif
 
 #include "descriptor.h"
 #include "lufa.h"
 
+#if defined(HID_COMMAND_ENABLE) && CONSOLE_EPSIZE != HID_COMMAND_SIZE
+#   error "HID_COMMAND_SIZE must be equal to CONSOLE_EPSIZE"
+#endif
+
 uint8_t keyboard_idle = 0;
 uint8_t keyboard_protocol = 1;
 static uint8_t keyboard_led_stats = 0;
@@ -65,14 +72,20 @@ static void send_keyboard(report_keyboard_t *report);
 static void send_mouse(report_mouse_t *report);
 static void send_system(uint16_t data);
 static void send_consumer(uint16_t data);
+static uint8_t keyboard_caps(void);
 host_driver_t lufa_driver = {
     keyboard_leds,
     send_keyboard,
     send_mouse,
     send_system,
-    send_consumer
+    send_consumer,
+    keyboard_caps
 };
 
+#if KEYBOARD_REPORT_SIZE > KEYBOARD_EPSIZE && !defined(NKRO_ENABLE)
+#   error "Keyboard report doesn't fit in KEYBOARD_EPSIZE. Reduce KEYBOARD_HYBRID_BITS."
+#endif
+
 
 /*******************************************************************************
  * Console
@@ -86,24 +99,24 @@ static void Console_Task(void)
 
     uint8_t ep = Endpoint_GetCurrentEndpoint();
 
-#if 0
-    // TODO: impl receivechar()/recvchar()
+#ifdef HID_COMMAND_ENABLE
     Endpoint_SelectEndpoint(CONSOLE_OUT_EPNUM);
 
-    /* Check to see if a packet has been sent from the host */
-    if (Endpoint_IsOUTReceived())
+    /* Check to see if a packet has been sent from the host; leave it in bank
+     * until previous request is answered */
+    if (Endpoint_IsOUTReceived() && hid_command_ready())
     {
         /* Check to see if the packet contains data */
         if (Endpoint_IsReadWriteAllowed())
         {
             /* Create a temporary buffer to hold the read in report from the host */
             uint8_t ConsoleData[CONSOLE_EPSIZE];
- 
+
             /* Read Console Report Data */
             Endpoint_Read_Stream_LE(&ConsoleData, sizeof(ConsoleData), NULL);
- 
-            /* Process Console Report Data */
-            //ProcessConsoleHIDReport(ConsoleData);
+
+            /* Process Console Report Data in main loop */
+            hid_command_receive(ConsoleData);
         }
 
         /* Finalize the stream transfer to send the last packet */
@@ -118,6 +131,17 @@ static void Console_Task(void)
         return;
     }
 
+#ifdef HID_COMMAND_ENABLE
+    // response or trace goes in a bank with no sendchar data
+    if (Endpoint_IsReadWriteAllowed() && Endpoint_BytesInEndpoint() == 0) {
+        uint8_t data[CONSOLE_EPSIZE];
+        if (hid_command_transmit(data)) {
+            Endpoint_Write_Stream_LE(data, CONSOLE_EPSIZE, NULL);
+            Endpoint_ClearIN();
+        }
+    }
+#endif
+
     // fill empty bank
     while (Endpoint_IsReadWriteAllowed())
         Endpoint_Write_8(0);
@@ -211,25 +235,25 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 
     /* Setup Keyboard HID Report Endpoints */
     ConfigSuccess &= ENDPOINT_CONFIG(KEYBOARD_IN_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN,
-                                     KEYBOARD_EPSIZE, ENDPOINT_BANK_SINGLE);
+                                     KEYBOARD_EPSIZE, USB_HID_BANK);
 
 #ifdef MOUSE_ENABLE
     /* Setup Mouse HID Report Endpoint */
     ConfigSuccess &= ENDPOINT_CONFIG(MOUSE_IN_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN,
-                                     MOUSE_EPSIZE, ENDPOINT_BANK_SINGLE);
+                                     MOUSE_EPSIZE, USB_HID_BANK);
 #endif
 
 #ifdef EXTRAKEY_ENABLE
     /* Setup Extra HID Report Endpoint */
     ConfigSuccess &= ENDPOINT_CONFIG(EXTRAKEY_IN_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN,
-                                     EXTRAKEY_EPSIZE, ENDPOINT_BANK_SINGLE);
+                                     EXTRAKEY_EPSIZE, USB_HID_BANK);
 #endif
 
 #ifdef CONSOLE_ENABLE
     /* Setup Console HID Report Endpoints */
     ConfigSuccess &= ENDPOINT_CONFIG(CONSOLE_IN_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN,
                                      CONSOLE_EPSIZE, ENDPOINT_BANK_DOUBLE);
-#if 0
+#ifdef HID_COMMAND_ENABLE
     ConfigSuccess &= ENDPOINT_CONFIG(CONSOLE_OUT_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_OUT,
                                      CONSOLE_EPSIZE, ENDPOINT_BANK_SINGLE);
 #endif
@@ -238,7 +262,7 @@ void EVENT_USB_Device_ConfigurationChanged(void)
 #ifdef NKRO_ENABLE
     /* Setup NKRO HID Report Endpoints */
     ConfigSuccess &= ENDPOINT_CONFIG(NKRO_IN_EPNUM, EP_TYPE_INTERRUPT, ENDPOINT_DIR_IN,
-                                     NKRO_EPSIZE, ENDPOINT_BANK_SINGLE);
+                                     NKRO_EPSIZE, USB_HID_BANK);
 #endif
 }
 
@@ -277,6 +301,10 @@ void EVENT_USB_Device_ControlRequest(void)
                     // TODO: test/check
                     ReportData = (uint8_t*)&keyboard_report_sent;
                     ReportSize = sizeof(keyboard_report_sent);
+#ifdef HYBRID_KRO_ENABLE
+                    /* bitmap is appended only in report protocol */
+                    if (!keyboard_protocol) ReportSize = KEYBOARD_REPORT_BOOT_SIZE;
+#endif
                     break;
                 }
 
@@ -400,12 +428,17 @@ static void send_keyboard(report_keyboard_t *report)
         /* Boot protocol */
         Endpoint_SelectEndpoint(KEYBOARD_IN_EPNUM);
 
-        /* Check if write ready for a polling interval around 10ms */
-        while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
+        /* Check if write ready for a polling interval */
+        while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(4 * USB_POLLING_INTERVAL);
         if (!Endpoint_IsReadWriteAllowed()) return;
 
         /* Write Keyboard Report Data */
+#ifdef HYBRID_KRO_ENABLE
+        /* bitmap is appended only in report protocol */
+        Endpoint_Write_Stream_LE(report, keyboard_protocol ? KEYBOARD_REPORT_SIZE : KEYBOARD_REPORT_BOOT_SIZE, NULL);
+#else
         Endpoint_Write_Stream_LE(report, KEYBOARD_EPSIZE, NULL);
+#endif
     }
 
     /* Finalize the stream transfer to send the last packet */
@@ -414,6 +447,14 @@ static void send_keyboard(report_keyboard_t *report)
     keyboard_report_sent = *report;
 }
 
+static uint8_t keyboard_caps(void)
+{
+#ifdef HYBRID_KRO_ENABLE
+    if (keyboard_protocol) return HOST_KEYBOARD_HYBRID;
+#endif
+    return HOST_KEYBOARD_BOOT;
+}
+
 static void send_mouse(report_mouse_t *report)
 {
 #ifdef MOUSE_ENABLE
@@ -425,8 +466,8 @@ static void send_mouse(report_mouse_t *report)
     /* Select the Mouse Report Endpoint */
     Endpoint_SelectEndpoint(MOUSE_IN_EPNUM);
 
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
+    /* Check if write ready for a polling interval */
+    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(4 * USB_POLLING_INTERVAL);
     if (!Endpoint_IsReadWriteAllowed()) return;
 
     /* Write Mouse Report Data */
@@ -450,8 +491,8 @@ static void send_system(uint16_t data)
     };
     Endpoint_SelectEndpoint(EXTRAKEY_IN_EPNUM);
 
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
+    /* Check if write ready for a polling interval */
+    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(4 * USB_POLLING_INTERVAL);
     if (!Endpoint_IsReadWriteAllowed()) return;
 
     Endpoint_Write_Stream_LE(&r, sizeof(report_extra_t), NULL);
@@ -471,8 +512,8 @@ static void send_consumer(uint16_t data)
     };
     Endpoint_SelectEndpoint(EXTRAKEY_IN_EPNUM);
 
-    /* Check if write ready for a polling interval around 10ms */
-    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(40);
+    /* Check if write ready for a polling interval */
+    while (timeout-- && !Endpoint_IsReadWriteAllowed()) _delay_us(4 * USB_POLLING_INTERVAL);
     if (!Endpoint_IsReadWriteAllowed()) return;
 
     Endpoint_Write_Stream_LE(&r, sizeof(report_extra_t), NULL);
@@ -31,13 +31,15 @@ static void send_keyboard(report_keyboard_t *report);
 static void send_mouse(report_mouse_t *report);
 static void send_system(uint16_t data);
 static void send_consumer(uint16_t data);
+static uint8_t keyboard_caps(void);
 
 static host_driver_t driver = {
         keyboard_leds,
         send_keyboard,
         send_mouse,
         send_system,
-        send_consumer
+        send_consumer,
+        keyboard_caps
 };
 
 host_driver_t *pjrc_driver(void)
@@ -74,3 +76,11 @@ static void send_consumer(uint16_t data)
     usb_extra_consumer_send(data);
 #endif
 }
+
+static uint8_t keyboard_caps(void)
+{
+#ifdef HYBRID_KRO_ENABLE
+    if (keyboard_protocol) return HOST_KEYBOARD_HYBRID;
+#endif
+    return HOST_KEYBOARD_BOOT;
+}
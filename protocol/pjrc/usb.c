@@ -181,6 +181,19 @@ static const uint8_t PROGMEM keyboard_hid_report_desc[] = {
         0x95, 0x01,          //   Report Count (1),
         0x75, 0x03,          //   Report Size (3),
         0x91, 0x03,          //   Output (Constant),                 ;LED report padding
+#ifdef HYBRID_KRO_ENABLE
+        0x95, KBD_REPORT_KEYS,    //   Report Count (),
+        0x75, 0x08,          //   Report Size (8),
+        0x81, 0x03,          //   Input (Constant),                 ;Boot report keys
+        0x95, KEYBOARD_REPORT_BITS*8, //   Report Count (),
+        0x75, 0x01,          //   Report Size (1),
+        0x15, 0x00,          //   Logical Minimum (0),
+        0x25, 0x01,          //   Logical Maximum(1),
+        0x05, 0x07,          //   Usage Page (Key Codes),
+        0x19, 0x00,          //   Usage Minimum (0),
+        0x29, KEYBOARD_REPORT_BITS*8-1, //   Usage Maximum (),
+        0x81, 0x02,          //   Input (Data, Variable, Absolute), ;Key bitmap
+#else
         0x95, KBD_REPORT_KEYS,    //   Report Count (),
         0x75, 0x08,          //   Report Size (8),
         0x15, 0x00,          //   Logical Minimum (0),
@@ -189,6 +202,7 @@ static const uint8_t PROGMEM keyboard_hid_report_desc[] = {
         0x19, 0x00,          //   Usage Minimum (0),
         0x29, 0xFF,          //   Usage Maximum (255),
         0x81, 0x00,          //   Input (Data, Array),
+#endif
         0xc0                 // End Collection
 };
 #ifdef NKRO_ENABLE
@@ -121,9 +121,14 @@ void usb_remote_wakeup(void);
  *------------------------------------------------------------------*/
 #define KBD_INTERFACE		0
 #define KBD_ENDPOINT		1
+#ifdef HYBRID_KRO_ENABLE
+#define KBD_SIZE		32
+#define KBD_REPORT_KEYS		6
+#else
 #define KBD_SIZE		8
-#define KBD_BUFFER		EP_SINGLE_BUFFER
 #define KBD_REPORT_KEYS		(KBD_SIZE - 2)
+#endif
+#define KBD_BUFFER		EP_SINGLE_BUFFER
 
 // secondary keyboard
 #ifdef NKRO_ENABLE
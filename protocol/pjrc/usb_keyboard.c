@@ -61,7 +61,13 @@ int8_t usb_keyboard_send_report(report_keyboard_t *report)
     else
 #endif
     {
+#ifdef HYBRID_KRO_ENABLE
+        /* bitmap is appended only in report protocol */
+        result = send_report(report, KBD_ENDPOINT, 0,
+                             keyboard_protocol ? KEYBOARD_REPORT_SIZE : KEYBOARD_REPORT_BOOT_SIZE);
+#else
         result = send_report(report, KBD_ENDPOINT, 0, KBD_SIZE);
+#endif
     }
 
     if (result) return result;
@@ -28,12 +28,23 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 static report_mouse_t mouse_report = {};
+static uint8_t mouse_id = PS2_MOUSE_ID_STANDARD;
 
 
+static void ps2_mouse_process(uint8_t *packet);
 static void print_usb_data(void);
 
 
-/* supports only 3 button mouse at this time */
+/* sets sample rate sequence and returns device ID answered */
+static uint8_t ps2_mouse_knock(uint8_t r1, uint8_t r2, uint8_t r3)
+{
+    ps2_host_send(PS2_MOUSE_SET_SAMPLE_RATE); ps2_host_send(r1);
+    ps2_host_send(PS2_MOUSE_SET_SAMPLE_RATE); ps2_host_send(r2);
+    ps2_host_send(PS2_MOUSE_SET_SAMPLE_RATE); ps2_host_send(r3);
+    if (ps2_host_send(PS2_MOUSE_GET_DEVICE_ID) != PS2_ACK) return PS2_MOUSE_ID_STANDARD;
+    return ps2_host_recv_response();
+}
+
 uint8_t ps2_mouse_init(void) {
     uint8_t rcv;
 
@@ -42,7 +53,7 @@ uint8_t ps2_mouse_init(void) {
     _delay_ms(1000);    // wait for powering up
 
     // send Reset
-    rcv = ps2_host_send(0xFF);
+    rcv = ps2_host_send(PS2_MOUSE_RESET);
     print("ps2_mouse_init: send Reset: ");
     phex(rcv); phex(ps2_error); print("\n");
 
@@ -56,73 +67,151 @@ uint8_t ps2_mouse_init(void) {
     print("ps2_mouse_init: read DevID: ");
     phex(rcv); phex(ps2_error); print("\n");
 
-    // send Set Remote mode
-    rcv = ps2_host_send(0xF0);
-    print("ps2_mouse_init: send 0xF0: ");
+    // IntelliMouse: wheel(200,100,80) and then 5-button(200,200,80)
+    mouse_id = ps2_mouse_knock(200, 100, 80);
+    if (mouse_id == PS2_MOUSE_ID_WHEEL) {
+        if (ps2_mouse_knock(200, 200, 80) == PS2_MOUSE_ID_5BUTTON) {
+            mouse_id = PS2_MOUSE_ID_5BUTTON;
+        }
+    } else {
+        mouse_id = PS2_MOUSE_ID_STANDARD;
+    }
+    print("ps2_mouse_init: ID: "); phex(mouse_id); print("\n");
+
+    // restore default sample rate
+    ps2_host_send(PS2_MOUSE_SET_SAMPLE_RATE);
+    ps2_host_send(100);
+
+#ifdef PS2_MOUSE_USE_REMOTE_MODE
+    rcv = ps2_host_send(PS2_MOUSE_SET_REMOTE_MODE);
+    print("ps2_mouse_init: send Set Remote mode: ");
+    phex(rcv); phex(ps2_error); print("\n");
+#else
+    rcv = ps2_host_send(PS2_MOUSE_SET_STREAM_MODE);
+    print("ps2_mouse_init: send Set Stream mode: ");
+    phex(rcv); phex(ps2_error); print("\n");
+
+    rcv = ps2_host_send(PS2_MOUSE_ENABLE_DATA_REPORTING);
+    print("ps2_mouse_init: send Enable Data Reporting: ");
     phex(rcv); phex(ps2_error); print("\n");
+#endif
 
     return 0;
 }
 
-#define X_IS_NEG  (mouse_report.buttons & (1<<PS2_MOUSE_X_SIGN))
-#define Y_IS_NEG  (mouse_report.buttons & (1<<PS2_MOUSE_Y_SIGN))
-#define X_IS_OVF  (mouse_report.buttons & (1<<PS2_MOUSE_X_OVFLW))
-#define Y_IS_OVF  (mouse_report.buttons & (1<<PS2_MOUSE_Y_OVFLW))
+#define PACKET_SIZE  (mouse_id == PS2_MOUSE_ID_STANDARD ? 3 : 4)
+
+#ifdef PS2_MOUSE_USE_REMOTE_MODE
 void ps2_mouse_task(void)
 {
-    enum { SCROLL_NONE, SCROLL_BTN, SCROLL_SENT };
-    static uint8_t scroll_state = SCROLL_NONE;
-    static uint8_t buttons_prev = 0;
+    uint8_t packet[4] = {};
 
-    /* receives packet from mouse */
-    uint8_t rcv;
-    rcv = ps2_host_send(PS2_MOUSE_READ_DATA);
-    if (rcv == PS2_ACK) {
-        mouse_report.buttons = ps2_host_recv_response();
-        mouse_report.x = ps2_host_recv_response();
-        mouse_report.y = ps2_host_recv_response();
-    } else {
+    /* polls packet from mouse */
+    if (ps2_host_send(PS2_MOUSE_READ_DATA) != PS2_ACK) {
         if (debug_mouse) print("ps2_mouse: fail to get mouse packet\n");
         return;
     }
-        xprintf("%ud ", timer_read());
-        print("ps2_mouse raw: [");
-        phex(mouse_report.buttons); print("|");
-        print_hex8((uint8_t)mouse_report.x); print(" ");
-        print_hex8((uint8_t)mouse_report.y); print("]\n");
+    for (uint8_t i = 0; i < PACKET_SIZE; i++) {
+        packet[i] = ps2_host_recv_response();
+    }
+    ps2_mouse_process(packet);
+}
+#else
+/*
+ * Assembles packet from bytes which mouse pushes into receive buffer.
+ * Never waits for mouse; returns at once when no data is available.
+ *
+ * Sync recovery:
+ * - byte 0 always has bit3 set, otherwise the byte is discarded
+ * - 4th byte of 5-button mouse has bit7 and bit6 cleared
+ * - partial packet is discarded when rest of it doesn't arrive in time
+ */
+void ps2_mouse_task(void)
+{
+    static uint8_t packet[4];
+    static uint8_t index = 0;
+    static uint16_t last_time = 0;
+
+    if (index && timer_elapsed(last_time) > PS2_MOUSE_SYNC_TIMEOUT) {
+        if (debug_mouse) print("ps2_mouse: sync timeout\n");
+        index = 0;
+    }
 
-    /* if mouse moves or buttons state changes */
-    if (mouse_report.x || mouse_report.y ||
-            ((mouse_report.buttons ^ buttons_prev) & PS2_MOUSE_BTN_MASK)) {
+    while (true) {
+        uint8_t data = ps2_host_recv();
+        if (ps2_error == PS2_ERR_NODATA) break;
+        last_time = timer_read();
+
+        if (index == 0 && !(data & (1<<PS2_MOUSE_ALWAYS_1))) {
+            if (debug_mouse) { print("ps2_mouse: out of sync: "); phex(data); print("\n"); }
+            continue;
+        }
+        if (index == 3 && mouse_id == PS2_MOUSE_ID_5BUTTON && (data & 0xC0)) {
+            if (debug_mouse) { print("ps2_mouse: out of sync: "); phex(data); print("\n"); }
+            index = 0;
+            continue;
+        }
+
+        packet[index++] = data;
+        if (index == PACKET_SIZE) {
+            index = 0;
+            ps2_mouse_process(packet);
+        }
+    }
+}
+#endif
+
+#define X_IS_NEG  (packet[0] & (1<<PS2_MOUSE_X_SIGN))
+#define Y_IS_NEG  (packet[0] & (1<<PS2_MOUSE_Y_SIGN))
+#define X_IS_OVF  (packet[0] & (1<<PS2_MOUSE_X_OVFLW))
+#define Y_IS_OVF  (packet[0] & (1<<PS2_MOUSE_Y_OVFLW))
+static void ps2_mouse_process(uint8_t *packet)
+{
+    enum { SCROLL_NONE, SCROLL_BTN, SCROLL_SENT };
+    static uint8_t scroll_state = SCROLL_NONE;
+    static uint8_t buttons_prev = 0;
+    int16_t x, y, v = 0, h = 0;
 
 #ifdef PS2_MOUSE_DEBUG
-        print("ps2_mouse raw: [");
-        phex(mouse_report.buttons); print("|");
-        print_hex8((uint8_t)mouse_report.x); print(" ");
-        print_hex8((uint8_t)mouse_report.y); print("]\n");
+    print("ps2_mouse raw: [");
+    phex(packet[0]); print("|");
+    print_hex8(packet[1]); print(" ");
+    print_hex8(packet[2]); print(" ");
+    print_hex8(packet[3]); print("]\n");
 #endif
 
+    mouse_report.buttons = packet[0] & PS2_MOUSE_BTN_MASK;
+    if (mouse_id == PS2_MOUSE_ID_5BUTTON) {
+        // 4th and 5th button
+        mouse_report.buttons |= (packet[3] & 0x30) >> 1;
+    }
+
+    /* if mouse moves or buttons state changes */
+    if (packet[1] || packet[2] || (mouse_id != PS2_MOUSE_ID_STANDARD && packet[3]) ||
+            (mouse_report.buttons ^ buttons_prev)) {
+
         buttons_prev = mouse_report.buttons;
 
         // PS/2 mouse data is '9-bit integer'(-256 to 255) which is comprised of sign-bit and 8-bit value.
         // bit: 8    7 ... 0
         //      sign \8-bit/
         //
-        // Meanwhile USB HID mouse indicates 8bit data(-127 to 127), note that -128 is not used.
-        //
-        // This converts PS/2 data into HID value. Use only -127-127 out of PS/2 9-bit.
-        mouse_report.x = X_IS_NEG ?
-                          ((!X_IS_OVF && -127 <= mouse_report.x && mouse_report.x <= -1) ?  mouse_report.x : -127) :
-                          ((!X_IS_OVF && 0 <= mouse_report.x && mouse_report.x <= 127) ? mouse_report.x : 127);
-        mouse_report.y = Y_IS_NEG ?
-                          ((!Y_IS_OVF && -127 <= mouse_report.y && mouse_report.y <= -1) ?  mouse_report.y : -127) :
-                          ((!Y_IS_OVF && 0 <= mouse_report.y && mouse_report.y <= 127) ? mouse_report.y : 127);
-
-        // remove sign and overflow flags
-        mouse_report.buttons &= PS2_MOUSE_BTN_MASK;
+        // This converts PS/2 data into 16-bit value and host accumulates it,
+        // clamping to HID range happens only when report is sent.
+        // On overflow actual movement is lost; take the largest value instead.
+        x = X_IS_OVF ? (X_IS_NEG ? -256 : 255) : (X_IS_NEG ? (int16_t)(0xFF00 | packet[1]) : packet[1]);
+        y = Y_IS_OVF ? (Y_IS_NEG ? -256 : 255) : (Y_IS_NEG ? (int16_t)(0xFF00 | packet[2]) : packet[2]);
 
         // invert coordinate of y to conform to USB HID mouse
-        mouse_report.y = -mouse_report.y;
+        y = -y;
+
+        // wheel: positive is down on PS/2 while up on USB HID
+        if (mouse_id == PS2_MOUSE_ID_WHEEL) {
+            v = -(int8_t)packet[3];
+        } else if (mouse_id == PS2_MOUSE_ID_5BUTTON) {
+            // 4-bit signed value
+            v = -((int8_t)(packet[3] << 4) >> 4);
+        }
 
 
 #if PS2_MOUSE_SCROLL_BTN_MASK
@@ -136,14 +225,13 @@ void ps2_mouse_task(void)
             // doesn't send Scroll Button
             //mouse_report.buttons &= ~(PS2_MOUSE_SCROLL_BTN_MASK);
 
-            if (mouse_report.x || mouse_report.y) {
+            if (x || y) {
                 scroll_state = SCROLL_SENT;
 
-                mouse_report.v = -mouse_report.y/(PS2_MOUSE_SCROLL_DIVISOR_V);
-                mouse_report.h =  mouse_report.x/(PS2_MOUSE_SCROLL_DIVISOR_H);
-                mouse_report.x = 0;
-                mouse_report.y = 0;
-                //host_mouse_send(&mouse_report);
+                v = -y/(PS2_MOUSE_SCROLL_DIVISOR_V);
+                h =  x/(PS2_MOUSE_SCROLL_DIVISOR_H);
+                x = 0;
+                y = 0;
             }
         }
         else if ((mouse_report.buttons & (PS2_MOUSE_SCROLL_BTN_MASK)) == 0) {
@@ -151,10 +239,8 @@ void ps2_mouse_task(void)
             if (scroll_state == SCROLL_BTN &&
                     TIMER_DIFF_16(timer_read(), scroll_button_time) < PS2_MOUSE_SCROLL_BTN_SEND) {
                 // send Scroll Button(down and up at once) when not scrolled
-                mouse_report.buttons |= (PS2_MOUSE_SCROLL_BTN_MASK);
-                host_mouse_send(&mouse_report);
+                host_mouse_move(mouse_report.buttons | (PS2_MOUSE_SCROLL_BTN_MASK), 0, 0, 0, 0);
                 _delay_ms(100);
-                mouse_report.buttons &= ~(PS2_MOUSE_SCROLL_BTN_MASK);
             }
 #endif
             scroll_state = SCROLL_NONE;
@@ -164,8 +250,12 @@ void ps2_mouse_task(void)
 #endif
 
 
-        host_mouse_send(&mouse_report);
+        mouse_report.x = x;
+        mouse_report.y = y;
+        mouse_report.v = v;
+        mouse_report.h = h;
         print_usb_data();
+        host_mouse_move(mouse_report.buttons, x, y, v, h);
     }
     // clear report
     mouse_report.x = 0;
@@ -209,7 +299,10 @@ static void print_usb_data(void)
  * Stream Mode: devices sends the data when it changs its state
  * Remote Mode: host polls the data periodically
  *
- * This code uses Remote Mode and polls the data with Read Data(0xEB).
+ * This code uses Stream Mode and assembles packets from receive buffer
+ * of interrupt driven PS/2 library(PS2_USE_INT or PS2_USE_USART).
+ * Remote Mode with polling by Read Data(0xEB) is used with PS2_USE_BUSYWAIT
+ * or when PS2_MOUSE_USE_REMOTE_MODE is defined.
  *
  * Data format:
  * byte|7       6       5       4       3       2       1       0
@@ -217,4 +310,10 @@ static void print_usb_data(void)
  *    0|Yovflw  Xovflw  Ysign   Xsign   1       Middle  Right   Left
  *    1|                    X movement
  *    2|                    Y movement
+ *
+ * IntelliMouse(ID:3) with wheel:
+ *    3|                    Z movement
+ *
+ * IntelliMouse Explorer(ID:4) with wheel and 5 buttons:
+ *    3|0       0       5th     4th     Z3      Z2      Z1      Z0
  */
@@ -20,7 +20,29 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdbool.h>
 
-#define PS2_MOUSE_READ_DATA     0xEB
+/* commands */
+#define PS2_MOUSE_RESET                 0xFF
+#define PS2_MOUSE_ENABLE_DATA_REPORTING 0xF4
+#define PS2_MOUSE_SET_SAMPLE_RATE       0xF3
+#define PS2_MOUSE_GET_DEVICE_ID         0xF2
+#define PS2_MOUSE_SET_REMOTE_MODE       0xF0
+#define PS2_MOUSE_READ_DATA             0xEB
+#define PS2_MOUSE_SET_STREAM_MODE       0xEA
+
+/* device ID */
+#define PS2_MOUSE_ID_STANDARD   0x00
+#define PS2_MOUSE_ID_WHEEL      0x03
+#define PS2_MOUSE_ID_5BUTTON    0x04
+
+/* Stream mode needs interrupt driven receiver */
+#if defined(PS2_USE_BUSYWAIT) && !defined(PS2_MOUSE_USE_REMOTE_MODE)
+#   define PS2_MOUSE_USE_REMOTE_MODE
+#endif
+
+/* discard partial packet when rest of it doesn't arrive within this(ms) */
+#ifndef PS2_MOUSE_SYNC_TIMEOUT
+#define PS2_MOUSE_SYNC_TIMEOUT  20
+#endif
 
 /*
  * Data format:
@@ -34,6 +56,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define PS2_MOUSE_BTN_LEFT      0
 #define PS2_MOUSE_BTN_RIGHT     1
 #define PS2_MOUSE_BTN_MIDDLE    2
+#define PS2_MOUSE_ALWAYS_1      3
 #define PS2_MOUSE_X_SIGN        4
 #define PS2_MOUSE_Y_SIGN        5
 #define PS2_MOUSE_X_OVFLW       6
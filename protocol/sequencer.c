@@ -0,0 +1,100 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+#include "debug.h"
+#include "sequencer.h"
+
+
+enum {
+    SEQ_IDLE,
+    SEQ_ACTION,
+    SEQ_DELAY,
+    SEQ_RESPONSE,
+};
+
+
+static void goto_step(sequencer_t *seq, uint8_t step)
+{
+    seq->step = step;
+    seq->state = (step < seq->count) ? SEQ_ACTION : SEQ_IDLE;
+}
+
+static void retry(sequencer_t *seq)
+{
+    const seq_step_t *s = &seq->steps[seq->step];
+
+    if (seq->max_retry && seq->retried >= seq->max_retry) {
+        dprintf("seq: step %d: give up\n", seq->step);
+        seq->failed = true;
+        seq->state = SEQ_IDLE;
+        return;
+    }
+    seq->retried++;
+    dprintf("seq: step %d: retry from %d\n", seq->step, s->retry);
+    goto_step(seq, s->retry);
+}
+
+void sequencer_start(sequencer_t *seq, uint8_t step)
+{
+    seq->retried = 0;
+    seq->failed = false;
+    seq->last = SEQ_WAIT;
+    goto_step(seq, step);
+}
+
+bool sequencer_task(sequencer_t *seq)
+{
+    const seq_step_t *s = &seq->steps[seq->step];
+
+    switch (seq->state) {
+        case SEQ_IDLE:
+            return false;
+        case SEQ_ACTION:
+            if (s->action) s->action();
+            seq->time = timer_read();
+            seq->state = SEQ_DELAY;
+            // FALL THROUGH
+        case SEQ_DELAY:
+            if (timer_elapsed(seq->time) < s->delay) break;
+            if (!s->response) {
+                goto_step(seq, seq->step + 1);
+                break;
+            }
+            seq->time = timer_read();
+            seq->state = SEQ_RESPONSE;
+            // FALL THROUGH
+        case SEQ_RESPONSE:
+            seq->last = s->response();
+            if (seq->last == SEQ_WAIT) {
+                if (timer_elapsed(seq->time) >= s->timeout) {
+                    dprintf("seq: step %d: timeout\n", seq->step);
+                    retry(seq);
+                }
+                break;
+            }
+            dprintf("seq: step %d: %02X\n", seq->step, seq->last);
+            if (s->expect != SEQ_ANY && seq->last != s->expect) {
+                retry(seq);
+                break;
+            }
+            goto_step(seq, seq->step + 1);
+            break;
+    }
+    return seq->state != SEQ_IDLE;
+}
@@ -0,0 +1,76 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/*
+ * Command/response sequencer
+ *
+ * Runs device initialization and command exchange without blocking. Steps are
+ * advanced from matrix_scan() with sequencer_task(), so converters get ready
+ * while USB enumerates. Each step:
+ *
+ *   1. calls 'action'(send command, drive pins) if any
+ *   2. waits 'delay' ms
+ *   3. polls 'response' for 'timeout' ms if any, then compares with 'expect'
+ *
+ * On timeout or unexpected response sequence goes back to step 'retry', or
+ * ends when 'retry' is past the last step. It gives up after 'max_retry'
+ * retries(0: retries forever).
+ *
+ * A single response byte without retry is simpler with serial_expect() and
+ * serial_response() of serial.h.
+ */
+#define SEQ_WAIT        -1      /* response() returns this while no data */
+#define SEQ_ANY         -2      /* expect: any response is accepted */
+
+typedef struct {
+    void (*action)(void);
+    uint16_t delay;
+    int16_t (*response)(void);
+    int16_t expect;
+    uint16_t timeout;
+    uint8_t retry;
+} seq_step_t;
+
+typedef struct {
+    const seq_step_t *steps;
+    uint8_t count;
+    uint8_t max_retry;
+    uint8_t step;
+    uint8_t state;
+    uint8_t retried;
+    uint16_t time;
+    int16_t last;       /* last response received, or SEQ_WAIT */
+    bool failed;        /* gave up retrying */
+} sequencer_t;
+
+#define SEQUENCER(steps, max_retry) \
+    { (steps), sizeof(steps) / sizeof((steps)[0]), (max_retry), 0, 0, 0, 0, SEQ_WAIT, false }
+
+
+/* starts sequence at step */
+void sequencer_start(sequencer_t *seq, uint8_t step);
+/* advances sequence, returns true while it is running */
+bool sequencer_task(sequencer_t *seq);
+
+#endif
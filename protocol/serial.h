@@ -44,4 +44,19 @@ uint8_t serial_recv(void);
 int16_t serial_recv2(void);
 void serial_send(uint8_t data);
 
+/* received bytes dropped since init: RX buffer full / parity error */
+uint16_t serial_overrun(void);
+uint16_t serial_error(void);
+
+
+/* Non-blocking response
+ *      serial_expect() starts waiting for a response byte, then
+ *      serial_response() is polled from matrix_scan() until it returns the byte
+ *      or SERIAL_TIMEOUT.
+ */
+#define SERIAL_WAIT     -1
+#define SERIAL_TIMEOUT  -2
+void serial_expect(uint16_t timeout);
+int16_t serial_response(void);
+
 #endif
@@ -27,14 +27,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 
-#ifdef MAX
-#undef MAX
-#endif
-#define MAX(X, Y) ((X) > (Y) ? (X) : (Y))
-
 static void print_usb_data(const report_mouse_t *report);
 
-void serial_mouse_task(void)
+static void serial_mouse_byte(uint8_t rcv)
 {
     /* 3 byte ring buffer */
     static uint8_t buffer[3];
@@ -42,15 +37,9 @@ void serial_mouse_task(void)
 
     static report_mouse_t report = {};
 
-    int16_t rcv;
-
-    rcv = serial_recv2();
-    if (rcv < 0)
-        /* no new data */
-        return;
 
     if (debug_mouse)
-        xprintf("serial_mouse: byte: %04X\n", rcv);
+        xprintf("serial_mouse: byte: %02X\n", rcv);
 
     /*
      * If bit 6 is one, this signals the beginning
@@ -59,7 +48,7 @@ void serial_mouse_task(void)
     if (rcv & (1 << 6))
         buffer_cur = 0;
 
-    buffer[buffer_cur] = (uint8_t)rcv;
+    buffer[buffer_cur] = rcv;
 
     if (buffer_cur == 0 && buffer[buffer_cur] == 0x20) {
         /*
@@ -70,7 +59,7 @@ void serial_mouse_task(void)
         report.x = report.y = 0;
 
         print_usb_data(&report);
-        host_mouse_send(&report);
+        host_mouse_move(report.buttons, 0, 0, 0, 0);
         return;
     }
 
@@ -92,12 +81,9 @@ void serial_mouse_task(void)
     if (buffer[0] & (1 << 4))
         report.buttons |= MOUSE_BTN2;
 
-    report.x = (buffer[0] << 6) | buffer[1];
-    report.y = ((buffer[0] << 4) & 0xC0) | buffer[2];
-
-    /* USB HID uses values from -127 to 127 only */
-    report.x = MAX(report.x, -127);
-    report.y = MAX(report.y, -127);
+    /* 8-bit signed movement; host clamps to HID range when sending */
+    report.x = (int8_t)((buffer[0] << 6) | buffer[1]);
+    report.y = (int8_t)(((buffer[0] << 4) & 0xC0) | buffer[2]);
 
 #if 0
     if (!report.buttons && !report.x && !report.y) {
@@ -110,7 +96,7 @@ void serial_mouse_task(void)
 #endif
 
     print_usb_data(&report);
-    host_mouse_send(&report);
+    host_mouse_move(report.buttons, report.x, report.y, 0, 0);
 }
 
 static void print_usb_data(const report_mouse_t *report)
@@ -122,3 +108,13 @@ static void print_usb_data(const report_mouse_t *report)
             report->buttons, report->x, report->y,
             report->v, report->h);
 }
+
+void serial_mouse_task(void)
+{
+    int16_t rcv;
+
+    /* drain all received bytes; motion is accumulated by host */
+    while ((rcv = serial_recv2()) >= 0) {
+        serial_mouse_byte(rcv);
+    }
+}
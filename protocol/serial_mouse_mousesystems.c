@@ -27,32 +27,25 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "print.h"
 #include "debug.h"
 
-#ifdef MAX
-#undef MAX
-#endif
-#define MAX(X, Y) ((X) > (Y) ? (X) : (Y))
-
 //#define SERIAL_MOUSE_CENTER_SCROLL
 
-static void print_usb_data(const report_mouse_t *report);
+static void print_usb_data(uint8_t buttons, int16_t x, int16_t y, int16_t v, int16_t h);
 
-void serial_mouse_task(void)
+static void serial_mouse_byte(uint8_t rcv)
 {
     /* 5 byte ring buffer */
     static uint8_t buffer[5];
     static int buffer_cur = 0;
 
-    int16_t rcv;
+    int16_t x, y;
+#ifdef SERIAL_MOUSE_CENTER_SCROLL
+    int16_t v, h;
+#endif
 
     report_mouse_t report = {0, 0, 0, 0, 0};
 
-    rcv = serial_recv2();
-    if (rcv < 0)
-        /* no new data */
-        return;
-
     if (debug_mouse)
-        xprintf("serial_mouse: byte: %04X\n", rcv);
+        xprintf("serial_mouse: byte: %02X\n", rcv);
 
     /*
      * Synchronization: mouse(4) says that all
@@ -64,7 +57,7 @@ void serial_mouse_task(void)
     if (buffer_cur == 0 && (rcv >> 3) != 0x10)
         return;
 
-    buffer[buffer_cur++] = (uint8_t)rcv;
+    buffer[buffer_cur++] = rcv;
 
     if (buffer_cur < 5)
         return;
@@ -72,21 +65,12 @@ void serial_mouse_task(void)
 
 #ifdef SERIAL_MOUSE_CENTER_SCROLL
     if ((buffer[0] & 0x7) == 0x5 && (buffer[1] || buffer[2])) {
-        /* USB HID uses only values from -127 to 127 */
-        report.h = MAX((int8_t)buffer[1], -127);
-        report.v = MAX((int8_t)buffer[2], -127);
-
-        print_usb_data(&report);
-        host_mouse_send(&report);
-
-        if (buffer[3] || buffer[4]) {
-            report.h = MAX((int8_t)buffer[3], -127);
-            report.v = MAX((int8_t)buffer[4], -127);
-
-            print_usb_data(&report);
-            host_mouse_send(&report);
-        }
+        /* two movements in a packet are accumulated into one report */
+        h = (int8_t)buffer[1] + (int8_t)buffer[3];
+        v = (int8_t)buffer[2] + (int8_t)buffer[4];
 
+        print_usb_data(report.buttons, 0, 0, v, h);
+        host_mouse_move(report.buttons, 0, 0, v, h);
         return;
     }
 #endif
@@ -104,28 +88,29 @@ void serial_mouse_task(void)
     if (!(buffer[0] & (1 << 0)))
         report.buttons |= MOUSE_BTN2;
 
-    /* USB HID uses only values from -127 to 127 */
-    report.x = MAX((int8_t)buffer[1], -127);
-    report.y = MAX(-(int8_t)buffer[2], -127);
+    /* two movements in a packet are accumulated into one report */
+    x = (int8_t)buffer[1] + (int8_t)buffer[3];
+    y = -((int8_t)buffer[2] + (int8_t)buffer[4]);
 
-    print_usb_data(&report);
-    host_mouse_send(&report);
-
-    if (buffer[3] || buffer[4]) {
-        report.x = MAX((int8_t)buffer[3], -127);
-        report.y = MAX(-(int8_t)buffer[4], -127);
-
-        print_usb_data(&report);
-        host_mouse_send(&report);
-    }
+    print_usb_data(report.buttons, x, y, 0, 0);
+    host_mouse_move(report.buttons, x, y, 0, 0);
 }
 
-static void print_usb_data(const report_mouse_t *report)
+static void print_usb_data(uint8_t buttons, int16_t x, int16_t y, int16_t v, int16_t h)
 {
     if (!debug_mouse)
         return;
 
     xprintf("serial_mouse usb: [%02X|%d %d %d %d]\n",
-            report->buttons, report->x, report->y,
-            report->v, report->h);
+            buttons, x, y, v, h);
+}
+
+void serial_mouse_task(void)
+{
+    int16_t rcv;
+
+    /* drain all received bytes; motion is accumulated by host */
+    while ((rcv = serial_recv2()) >= 0) {
+        serial_mouse_byte(rcv);
+    }
 }
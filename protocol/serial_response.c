@@ -0,0 +1,44 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <stdint.h>
+#include "timer.h"
+#include "serial.h"
+
+
+/*
+ * Non-blocking wait for response byte, works with serial_uart and serial_soft
+ */
+static uint16_t expect_time = 0;
+static uint16_t expect_timeout = 0;
+
+void serial_expect(uint16_t timeout)
+{
+    expect_time = timer_read();
+    expect_timeout = timeout;
+}
+
+int16_t serial_response(void)
+{
+    int16_t data = serial_recv2();
+    if (data != -1) {
+        return data;
+    }
+    if (timer_elapsed(expect_time) >= expect_timeout) {
+        return SERIAL_TIMEOUT;
+    }
+    return SERIAL_WAIT;
+}
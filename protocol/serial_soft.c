@@ -87,11 +87,32 @@ void serial_init(void)
 }
 
 /* RX ring buffer */
-#define RBUF_SIZE   8
+#ifdef SERIAL_SOFT_RBUF_SIZE
+    #define RBUF_SIZE   SERIAL_SOFT_RBUF_SIZE
+#else
+    #define RBUF_SIZE   16
+#endif
+#if RBUF_SIZE > 256 || (RBUF_SIZE & (RBUF_SIZE - 1))
+    #error "SERIAL_SOFT_RBUF_SIZE must be power of 2 and 256 or less"
+#endif
 static uint8_t rbuf[RBUF_SIZE];
 static uint8_t rbuf_head = 0;
 static uint8_t rbuf_tail = 0;
 
+/* dropped bytes */
+static uint16_t rbuf_overrun = 0;
+static uint16_t rbuf_error = 0;
+
+uint16_t serial_overrun(void)
+{
+    return rbuf_overrun;
+}
+
+uint16_t serial_error(void)
+{
+    return rbuf_error;
+}
+
 
 uint8_t serial_recv(void)
 {
@@ -227,10 +248,13 @@ ISR(SERIAL_SOFT_RXD_VECT)
 
     uint8_t next = (rbuf_head + 1) % RBUF_SIZE;
 #if defined(SERIAL_SOFT_PARITY_EVEN) || defined(SERIAL_SOFT_PARITY_ODD)
-    if ((parity == SERIAL_SOFT_PARITY_VAL) && next != rbuf_tail) {
-#else
-    if (next != rbuf_tail) {
+    if (parity != SERIAL_SOFT_PARITY_VAL) {
+        rbuf_error++;
+    } else
 #endif
+    if (next == rbuf_tail) {
+        rbuf_overrun++;
+    } else {
         rbuf[rbuf_head] = data;
         rbuf_head = next;
     }
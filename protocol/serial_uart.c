@@ -68,6 +68,19 @@ static uint8_t rbuf[RBUF_SIZE];
 static uint8_t rbuf_head = 0;
 static uint8_t rbuf_tail = 0;
 
+/* dropped bytes */
+static uint16_t rbuf_overrun = 0;
+
+uint16_t serial_overrun(void)
+{
+    return rbuf_overrun;
+}
+
+uint16_t serial_error(void)
+{
+    return 0;
+}
+
 uint8_t serial_recv(void)
 {
     uint8_t data = 0;
@@ -94,11 +107,43 @@ int16_t serial_recv2(void)
     return data;
 }
 
+#ifdef SERIAL_UART_TXD_VECT
+/*
+ * TX ring buffer drained by data register empty interrupt.
+ * Needs SERIAL_UART_TXD_INT_ON()/OFF() to control the interrupt.
+ */
+#ifndef SERIAL_UART_TBUF_SIZE
+#define SERIAL_UART_TBUF_SIZE   64
+#endif
+static uint8_t tbuf[SERIAL_UART_TBUF_SIZE];
+static volatile uint8_t tbuf_head = 0;
+static volatile uint8_t tbuf_tail = 0;
+
+void serial_send(uint8_t data)
+{
+    uint8_t next = (tbuf_head + 1) % SERIAL_UART_TBUF_SIZE;
+    while (next == tbuf_tail) ;     // full: wait for interrupt to drain
+    tbuf[tbuf_head] = data;
+    tbuf_head = next;
+    SERIAL_UART_TXD_INT_ON();
+}
+
+ISR(SERIAL_UART_TXD_VECT)
+{
+    if (tbuf_head == tbuf_tail) {
+        SERIAL_UART_TXD_INT_OFF();
+        return;
+    }
+    SERIAL_UART_DATA = tbuf[tbuf_tail];
+    tbuf_tail = (tbuf_tail + 1) % SERIAL_UART_TBUF_SIZE;
+}
+#else
 void serial_send(uint8_t data)
 {
     while (!SERIAL_UART_TXD_READY) ;
     SERIAL_UART_DATA = data;
 }
+#endif
 
 // USART RX complete interrupt
 ISR(SERIAL_UART_RXD_VECT)
@@ -107,6 +152,9 @@ ISR(SERIAL_UART_RXD_VECT)
     if (next != rbuf_tail) {
         rbuf[rbuf_head] = SERIAL_UART_DATA;
         rbuf_head = next;
+    } else {
+        (void)SERIAL_UART_DATA;
+        rbuf_overrun++;
     }
     rbuf_check_rts_hi();
 }
@@ -16,6 +16,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include <stdint.h>
+#include <string.h>
 #include "usbdrv.h"
 #include "usbconfig.h"
 #include "host.h"
@@ -29,18 +30,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 static uint8_t vusb_keyboard_leds = 0;
 static uint8_t vusb_idle_rate = 0;
 
-/* Keyboard report send buffer */
-#define KBUF_SIZE 16
-static report_keyboard_t kbuf[KBUF_SIZE];
-static uint8_t kbuf_head = 0;
-static uint8_t kbuf_tail = 0;
-
 typedef struct {
         uint8_t modifier;
         uint8_t reserved;
         uint8_t keycode[6];
 } keyboard_report_t;
 
+/* Keyboard report send buffer; low-speed endpoint carries boot report only */
+#define KBUF_SIZE 16
+static keyboard_report_t kbuf[KBUF_SIZE];
+static uint8_t kbuf_head = 0;
+static uint8_t kbuf_tail = 0;
+
 static keyboard_report_t keyboard_report; // sent to PC
 
 /* transfer keyboard report from buffer */
@@ -48,7 +49,7 @@ void vusb_transfer_keyboard(void)
 {
     if (usbInterruptIsReady()) {
         if (kbuf_head != kbuf_tail) {
-            usbSetInterrupt((void *)&kbuf[kbuf_tail], sizeof(report_keyboard_t));
+            usbSetInterrupt((void *)&kbuf[kbuf_tail], sizeof(keyboard_report_t));
             kbuf_tail = (kbuf_tail + 1) % KBUF_SIZE;
             if (debug_keyboard) {
                 print("V-USB: kbuf["); pdec(kbuf_tail); print("->"); pdec(kbuf_head); print("](");
@@ -90,7 +91,7 @@ static void send_keyboard(report_keyboard_t *report)
 {
     uint8_t next = (kbuf_head + 1) % KBUF_SIZE;
     if (next != kbuf_tail) {
-        kbuf[kbuf_head] = *report;
+        memcpy(&kbuf[kbuf_head], report, sizeof(keyboard_report_t));
         kbuf_head = next;
     } else {
         debug("kbuf: full\n");
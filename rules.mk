@@ -124,6 +124,10 @@ CFLAGS += -O$(OPT)
 CFLAGS += -funsigned-char
 CFLAGS += -funsigned-bitfields
 CFLAGS += -ffunction-sections
+# lets --gc-sections drop keymaps[] replaced by actionmap or sparse keymap
+ifneq (,$(ACTIONMAP_ENABLE)$(KEYMAP_SPARSE_ENABLE))
+CFLAGS += -fdata-sections
+endif
 CFLAGS += -fno-inline-small-functions
 CFLAGS += -fpack-struct
 CFLAGS += -fshort-enums
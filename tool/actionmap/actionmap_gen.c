@@ -0,0 +1,211 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Actionmap compiler
+ *
+ * Linked on host with keymap sources of a keyboard and common/keymap.c, then
+ * runs the firmware's own keycode to action translation for every key and
+ * emits the result as C source of actionmaps[][MATRIX_ROWS][MATRIX_COLS], or of
+ * sparse keymap which stores only non-transparent keys(see keymap.h).
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "keycode.h"
+#include "keymap.h"
+
+
+/* key format of sparse keymap(see keymap.h) */
+#define SPARSE_INDEX_BITS   10
+
+static int layers = 0;
+static int defer_fn = 0;
+
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s -l layers [-d] [-c] [-s source]\n", prog);
+    fprintf(stderr, "  -l layers   number of layers in keymap\n");
+    fprintf(stderr, "  -d          defer Fn keys to keymap_fn_to_action() at runtime\n");
+    fprintf(stderr, "  -c          emit sparse keymap instead of flat actionmap\n");
+    fprintf(stderr, "  -s source   keymap source name put in header comment\n");
+    exit(1);
+}
+
+static uint16_t key_action(uint8_t layer, keypos_t key)
+{
+    uint8_t keycode = keymap_key_to_keycode(layer, key);
+    if (defer_fn && IS_FN(keycode)) {
+        return ACTIONMAP_FN(keycode);
+    }
+    return action_for_key(layer, key).code;
+}
+
+static void emit_flat(void)
+{
+    printf("const uint16_t PROGMEM actionmaps[][MATRIX_ROWS][MATRIX_COLS] = {\n");
+    for (int layer = 0; layer < layers; layer++) {
+        printf("    /* %d */\n", layer);
+        printf("    {\n");
+        for (int row = 0; row < MATRIX_ROWS; row++) {
+            printf("        {");
+            for (int col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = { .row = row, .col = col };
+                printf(" 0x%04X%s", key_action(layer, key), (col < MATRIX_COLS - 1) ? "," : "");
+            }
+            printf(" },\n");
+        }
+        printf("    },\n");
+    }
+    printf("};\n");
+}
+
+static void emit_sparse_entries(int actions)
+{
+    int n = 0;
+    for (int row = 0; row < MATRIX_ROWS; row++) {
+        for (int col = 0; col < MATRIX_COLS; col++) {
+            keypos_t key = { .row = row, .col = col };
+            for (int layer = 0; layer < layers; layer++) {
+                uint8_t keycode = keymap_key_to_keycode(layer, key);
+                if (keycode == KC_TRNS) continue;
+                if (n % 8 == 0) printf("    ");
+                if (actions) {
+                    printf("0x%04X,", key_action(layer, key));
+                } else {
+                    printf("0x%02X,", keycode);
+                }
+                printf((++n % 8 == 0) ? "\n" : " ");
+            }
+        }
+    }
+    if (n % 8) printf("\n");
+}
+
+/* layers which define key */
+static uint32_t defined_layers(keypos_t key)
+{
+    uint32_t defined = 0;
+    for (int layer = 0; layer < layers; layer++) {
+        if (keymap_key_to_keycode(layer, key) != KC_TRNS) {
+            defined |= (1UL<<layer);
+        }
+    }
+    return defined;
+}
+
+static void emit_sparse(void)
+{
+    static uint32_t bitmaps[1<<(16 - SPARSE_INDEX_BITS)];
+    int nbitmaps = 0;
+    int stored = 0;
+
+    printf("#if KEYMAP_SPARSE_LAYERS < %d\n", layers);
+    printf("#error \"KEYMAP_SPARSE_LAYERS must be %d or more\"\n", layers);
+    printf("#endif\n");
+    printf("#if KEYMAP_SPARSE_INDEX_BITS != %d\n", SPARSE_INDEX_BITS);
+    printf("#error \"sparse keymap was generated for a different key format\"\n");
+    printf("#endif\n");
+    printf("\n");
+
+    printf("const uint16_t PROGMEM keymap_sparse_keys[MATRIX_ROWS][MATRIX_COLS] = {\n");
+    for (int row = 0; row < MATRIX_ROWS; row++) {
+        printf("    {");
+        for (int col = 0; col < MATRIX_COLS; col++) {
+            keypos_t key = { .row = row, .col = col };
+            uint32_t defined = defined_layers(key);
+            int id;
+            for (id = 0; id < nbitmaps; id++) {
+                if (bitmaps[id] == defined) break;
+            }
+            if (id == nbitmaps) {
+                if (nbitmaps == (1<<(16 - SPARSE_INDEX_BITS))) {
+                    fprintf(stderr, "more than %d layer bitmaps, use flat actionmap\n", nbitmaps);
+                    exit(1);
+                }
+                bitmaps[nbitmaps++] = defined;
+            }
+            if (stored >= (1<<SPARSE_INDEX_BITS)) {
+                fprintf(stderr, "more than %d entries, use flat actionmap\n", 1<<SPARSE_INDEX_BITS);
+                exit(1);
+            }
+            printf(" 0x%04X%s", (id << SPARSE_INDEX_BITS) | stored, (col < MATRIX_COLS - 1) ? "," : "");
+            stored += __builtin_popcountl(defined);
+        }
+        printf(" },\n");
+    }
+    printf("};\n\n");
+
+    printf("const keymap_layers_t PROGMEM keymap_sparse_layers[] = {\n");
+    for (int id = 0; id < nbitmaps; id++) {
+        if (id % 8 == 0) printf("    ");
+        printf("0x%0*lX,", (layers + 3) / 4, (unsigned long)bitmaps[id]);
+        printf((id % 8 == 7 || id == nbitmaps - 1) ? "\n" : " ");
+    }
+    printf("};\n\n");
+
+    printf("/* %d of %d keys are defined */\n", stored, layers * MATRIX_ROWS * MATRIX_COLS);
+    printf("#ifdef ACTIONMAP_ENABLE\n");
+    printf("const uint16_t PROGMEM keymap_sparse_entries[] = {\n");
+    emit_sparse_entries(1);
+    printf("};\n");
+    printf("#else\n");
+    printf("const uint8_t PROGMEM keymap_sparse_entries[] = {\n");
+    emit_sparse_entries(0);
+    printf("};\n");
+    printf("#endif\n");
+}
+
+int main(int argc, char **argv)
+{
+    int sparse = 0;
+    const char *source = "keymap";
+    int c;
+
+    while ((c = getopt(argc, argv, "l:dcs:")) != -1) {
+        switch (c) {
+            case 'l': layers = atoi(optarg); break;
+            case 'd': defer_fn = 1; break;
+            case 'c': sparse = 1; break;
+            case 's': source = optarg; break;
+            default: usage(argv[0]);
+        }
+    }
+    if (layers <= 0 || layers > 32) usage(argv[0]);
+
+    printf("/* Generated by tool/actionmap from %s. Do not edit. */\n", source);
+    printf("#include <stdint.h>\n");
+    printf("#include <avr/pgmspace.h>\n");
+    printf("#include \"keymap.h\"\n");
+    printf("\n");
+    printf("#if MATRIX_ROWS != %d || MATRIX_COLS != %d\n", MATRIX_ROWS, MATRIX_COLS);
+    printf("#error \"actionmap was generated for a different matrix size\"\n");
+    printf("#endif\n");
+    if (sparse) {
+        printf("#ifndef KEYMAP_SPARSE_ENABLE\n");
+        printf("#error \"sparse keymap needs KEYMAP_SPARSE_ENABLE\"\n");
+        printf("#endif\n");
+    }
+    printf("\n");
+    if (sparse) {
+        emit_sparse();
+    } else {
+        emit_flat();
+    }
+    return 0;
+}
@@ -0,0 +1,27 @@
+/* host stub of avr-libc <avr/io.h>: registers touched by keyboard headers */
+#ifndef IO_H
+#define IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t host_io_reg;
+#define DDRB    host_io_reg
+#define PORTB   host_io_reg
+#define PINB    host_io_reg
+#define DDRC    host_io_reg
+#define PORTC   host_io_reg
+#define PINC    host_io_reg
+#define DDRD    host_io_reg
+#define PORTD   host_io_reg
+#define PIND    host_io_reg
+#define DDRE    host_io_reg
+#define PORTE   host_io_reg
+#define PINE    host_io_reg
+#define DDRF    host_io_reg
+#define PORTF   host_io_reg
+#define PINF    host_io_reg
+#define OCR1A   host_io_reg
+#define OCR1B   host_io_reg
+#define OCR1C   host_io_reg
+
+#endif
@@ -0,0 +1,8 @@
+/* host stub of avr-libc <util/delay.h> */
+#ifndef DELAY_H
+#define DELAY_H
+
+#define _delay_ms(ms)
+#define _delay_us(us)
+
+#endif
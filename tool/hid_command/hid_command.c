@@ -0,0 +1,354 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Host tool for binary command channel(common/hid_command.h)
+ *
+ * Talks to console interface of the keyboard through Linux hidraw. Device is
+ * found by its vendor usage page(0xFF31) unless given with -d.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/hidraw.h>
+#include "hid_command.h"
+
+
+#define CONSOLE_USAGE_PAGE  0xFF31
+#define TIMEOUT_MS          1000
+
+static int fd = -1;
+
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-d /dev/hidrawN] command [args]\n", prog);
+    fprintf(stderr, "  version\n");
+    fprintf(stderr, "  eeconfig                     show eeconfig\n");
+    fprintf(stderr, "  eeprom-read addr len\n");
+    fprintf(stderr, "  eeprom-write addr byte...\n");
+    fprintf(stderr, "  layer [state]                show or set layer_state\n");
+    fprintf(stderr, "  default-layer state          set default_layer_state\n");
+    fprintf(stderr, "  debug [raw]                  show or set debug_config\n");
+    fprintf(stderr, "  mousekey [d i ms ttm wms wttm]\n");
+    fprintf(stderr, "  stats\n");
+    fprintf(stderr, "  keystats                     per-key last edge, presses and chatter\n");
+    fprintf(stderr, "  keyhold                      hold time histogram\n");
+    fprintf(stderr, "  keystats-clear\n");
+    fprintf(stderr, "  trace                        stream matrix events until interrupted\n");
+    fprintf(stderr, "  keymap [layer]               show keys changed in keymap overlay\n");
+    fprintf(stderr, "  keymap-set layer row col entry\n");
+    fprintf(stderr, "  keymap-del layer row col     back to keymap in flash\n");
+    fprintf(stderr, "  keymap-clear\n");
+    exit(1);
+}
+
+/* console report descriptor starts with Usage Page(0xFF31) */
+static bool is_console(int f)
+{
+    int size = 0;
+    struct hidraw_report_descriptor desc;
+
+    if (ioctl(f, HIDIOCGRDESCSIZE, &size) < 0 || size < 3) return false;
+    desc.size = size;
+    if (ioctl(f, HIDIOCGRDESC, &desc) < 0) return false;
+    return desc.value[0] == 0x06 &&
+           (desc.value[1] | desc.value[2] << 8) == CONSOLE_USAGE_PAGE;
+}
+
+static int open_device(const char *path)
+{
+    if (path) return open(path, O_RDWR);
+
+    for (int i = 0; i < 64; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "/dev/hidraw%d", i);
+        int f = open(name, O_RDWR);
+        if (f < 0) continue;
+        if (is_console(f)) return f;
+        close(f);
+    }
+    errno = ENODEV;
+    return -1;
+}
+
+/* read next packet of the channel, skipping text console and padding */
+static int receive(uint8_t *packet, int timeout)
+{
+    struct pollfd p = { .fd = fd, .events = POLLIN };
+
+    for (;;) {
+        int r = poll(&p, 1, timeout);
+        if (r <= 0) return r;
+        r = read(fd, packet, HID_COMMAND_SIZE);
+        if (r <= 0) return -1;
+        if (r == HID_COMMAND_SIZE && packet[0] == 0 && packet[1] != 0) return r;
+    }
+}
+
+static uint8_t *request(uint8_t command, const uint8_t *args, int len)
+{
+    static uint8_t packet[HID_COMMAND_SIZE];
+    uint8_t out[HID_COMMAND_SIZE + 1] = { 0 };  /* report id 0 */
+
+    out[1] = command;
+    memcpy(&out[2], args, len);
+    if (write(fd, out, sizeof(out)) < 0) {
+        perror("write");
+        exit(1);
+    }
+
+    for (;;) {
+        if (receive(packet, TIMEOUT_MS) <= 0) {
+            fprintf(stderr, "no response\n");
+            exit(1);
+        }
+        if (packet[1] == command) break;
+    }
+    switch (packet[2]) {
+        case HID_COMMAND_OK:
+            return &packet[3];
+        case HID_COMMAND_UNKNOWN:
+            fprintf(stderr, "unknown command\n");
+            break;
+        case HID_COMMAND_BAD_ARGUMENT:
+            fprintf(stderr, "bad argument\n");
+            break;
+        case HID_COMMAND_UNSUPPORTED:
+            fprintf(stderr, "not supported by firmware\n");
+            break;
+        default:
+            fprintf(stderr, "error %u\n", packet[2]);
+            break;
+    }
+    exit(1);
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return p[0] | p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    for (int i = 0; i < 4; i++) p[i] = v >> (i * 8);
+}
+
+static void eeprom_read(unsigned addr, unsigned len, uint8_t *buf)
+{
+    uint8_t args[3] = { addr & 0xFF, addr >> 8, len };
+    memcpy(buf, request(HID_COMMAND_EEPROM_READ, args, 3), len);
+}
+
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:")) != -1) {
+        if (opt == 'd') path = optarg;
+        else usage(argv[0]);
+    }
+    if (optind >= argc) usage(argv[0]);
+
+    fd = open_device(path);
+    if (fd < 0) {
+        perror(path ? path : "console interface");
+        return 1;
+    }
+
+    const char *cmd = argv[optind];
+    char **args = &argv[optind + 1];
+    int nargs = argc - optind - 1;
+    uint8_t buf[HID_COMMAND_SIZE] = { 0 };
+    uint8_t *data;
+
+    if (!strcmp(cmd, "version")) {
+        data = request(HID_COMMAND_GET_VERSION, NULL, 0);
+        printf("protocol: %u  matrix: %ux%u  overlay layers: %u\n", data[0], data[1], data[2], data[3]);
+    }
+    else if (!strcmp(cmd, "eeconfig")) {
+        /* layout of common/eeconfig.h */
+        eeprom_read(0, 7, buf);
+        printf("magic:          %04X\n", buf[0] | buf[1] << 8);
+        printf("debug:          %02X\n", buf[2]);
+        printf("default_layer:  %02X\n", buf[3]);
+        printf("keymap:         %02X\n", buf[4]);
+        printf("mousekey_accel: %02X\n", buf[5]);
+        printf("backlight:      %02X\n", buf[6]);
+    }
+    else if (!strcmp(cmd, "eeprom-read") && nargs == 2) {
+        unsigned addr = strtoul(args[0], NULL, 0);
+        unsigned len = strtoul(args[1], NULL, 0);
+        while (len) {
+            unsigned n = len < 16 ? len : 16;
+            eeprom_read(addr, n, buf);
+            printf("%04X:", addr);
+            for (unsigned i = 0; i < n; i++) printf(" %02X", buf[i]);
+            printf("\n");
+            addr += n;
+            len -= n;
+        }
+    }
+    else if (!strcmp(cmd, "eeprom-write") && nargs >= 2 && nargs - 1 <= HID_COMMAND_DATA_SIZE - 3) {
+        unsigned addr = strtoul(args[0], NULL, 0);
+        buf[0] = addr & 0xFF;
+        buf[1] = addr >> 8;
+        buf[2] = nargs - 1;
+        for (int i = 1; i < nargs; i++) buf[2 + i] = strtoul(args[i], NULL, 0);
+        request(HID_COMMAND_EEPROM_WRITE, buf, 3 + nargs - 1);
+    }
+    else if (!strcmp(cmd, "layer") && nargs <= 1) {
+        if (nargs) {
+            put32(buf, strtoul(args[0], NULL, 0));
+            request(HID_COMMAND_LAYER_SET, buf, 4);
+        }
+        data = request(HID_COMMAND_LAYER_GET, NULL, 0);
+        printf("layer_state:         %08X\n", get32(&data[0]));
+        printf("default_layer_state: %08X\n", get32(&data[4]));
+    }
+    else if (!strcmp(cmd, "default-layer") && nargs == 1) {
+        put32(buf, strtoul(args[0], NULL, 0));
+        request(HID_COMMAND_DEFAULT_LAYER_SET, buf, 4);
+    }
+    else if (!strcmp(cmd, "debug") && nargs <= 1) {
+        if (nargs) {
+            buf[0] = strtoul(args[0], NULL, 0);
+            data = request(HID_COMMAND_DEBUG_SET, buf, 1);
+        } else {
+            data = request(HID_COMMAND_DEBUG_GET, NULL, 0);
+        }
+        printf("debug_config: %02X(enable:%u matrix:%u keyboard:%u mouse:%u)\n", data[0],
+               data[0] & 1, (data[0] >> 1) & 1, (data[0] >> 2) & 1, (data[0] >> 3) & 1);
+    }
+    else if (!strcmp(cmd, "mousekey") && (nargs == 0 || nargs == 6)) {
+        if (nargs) {
+            for (int i = 0; i < 6; i++) buf[i] = strtoul(args[i], NULL, 0);
+            data = request(HID_COMMAND_MOUSEKEY_SET, buf, 6);
+        } else {
+            data = request(HID_COMMAND_MOUSEKEY_GET, NULL, 0);
+        }
+        printf("delay: %u  interval: %u  max_speed: %u  time_to_max: %u  "
+               "wheel_max_speed: %u  wheel_time_to_max: %u\n",
+               data[0], data[1], data[2], data[3], data[4], data[5]);
+    }
+    else if (!strcmp(cmd, "stats")) {
+        /* scan rate from two samples a second apart */
+        data = request(HID_COMMAND_STATS, NULL, 0);
+        uint32_t t0 = get32(&data[0]), s0 = get32(&data[4]);
+        sleep(1);
+        data = request(HID_COMMAND_STATS, NULL, 0);
+        uint32_t t1 = get32(&data[0]), s1 = get32(&data[4]);
+        printf("uptime:        %u ms\n", t1);
+        printf("scans:         %u(%.0f/s)\n", s1, t1 != t0 ? (s1 - s0) * 1000.0 / (t1 - t0) : 0.0);
+        printf("trace dropped: %u\n", data[8] | data[9] << 8);
+        printf("wakeup:        %u ms\n", data[10] | data[11] << 8);
+        printf("keyboard:     ");
+        for (int i = 12; i < HID_COMMAND_DATA_SIZE; i++) printf(" %02X", data[i]);
+        printf("\n");
+    }
+    else if (!strcmp(cmd, "keystats")) {
+        data = request(HID_COMMAND_GET_VERSION, NULL, 0);
+        uint8_t rows = data[1], cols = data[2];
+        printf("row col    last  presses chatter\n");
+        for (uint8_t r = 0; r < rows; r++) {
+            for (uint8_t c = 0; c < cols; ) {
+                uint8_t args[2] = { r, c };
+                data = request(HID_COMMAND_KEY_STATS, args, 2);
+                for (int i = 0; i < data[0]; i++, c++) {
+                    uint8_t *k = &data[1 + i * HID_COMMAND_KEY_STATS_SIZE];
+                    if (!(k[0] | k[1])) continue;
+                    printf("%3u %3u %7u %8u %7u%s\n", r, c, k[0] | k[1] << 8, k[2] | k[3] << 8, k[4],
+                           k[4] ? "  <- chatter" : "");
+                }
+            }
+        }
+    }
+    else if (!strcmp(cmd, "keyhold")) {
+        for (uint8_t b = 0; ; ) {
+            data = request(HID_COMMAND_KEY_HOLD, &b, 1);
+            if (!data[0]) break;
+            for (int i = 0; i < data[0]; i++, b++) {
+                printf("%5u- ms: %u\n", b * data[1], data[2 + i * 2] | data[3 + i * 2] << 8);
+            }
+        }
+    }
+    else if (!strcmp(cmd, "keystats-clear")) {
+        request(HID_COMMAND_KEY_STATS_CLEAR, NULL, 0);
+    }
+    else if (!strcmp(cmd, "trace")) {
+        buf[0] = 1;
+        request(HID_COMMAND_TRACE, buf, 1);
+        for (;;) {
+            uint8_t packet[HID_COMMAND_SIZE];
+            if (receive(packet, -1) < 0) break;
+            if (packet[1] != HID_COMMAND_TRACE_DATA) continue;
+            for (int i = 0; i < packet[2]; i++) {
+                uint8_t *e = &packet[3 + i * HID_COMMAND_TRACE_EVENT_SIZE];
+                printf("%5u r%02u c%02u %s\n", e[2] | e[3] << 8, e[0], e[1] & 0x7F,
+                       (e[1] & 0x80) ? "down" : "up");
+            }
+            fflush(stdout);
+        }
+    }
+    else if (!strcmp(cmd, "keymap") && nargs <= 1) {
+        data = request(HID_COMMAND_GET_VERSION, NULL, 0);
+        uint8_t rows = data[1], cols = data[2], layers = data[3];
+        uint8_t l = nargs ? strtoul(args[0], NULL, 0) : 0;
+        if (nargs) layers = l + 1;
+        printf("layer row col entry\n");
+        for (; l < layers; l++) {
+            for (uint8_t r = 0; r < rows; r++) {
+                for (uint8_t c = 0; c < cols; ) {
+                    uint8_t args[3] = { l, r, c };
+                    data = request(HID_COMMAND_KEYMAP_GET, args, 3);
+                    for (int i = 0; i < data[0]; i++, c++) {
+                        uint8_t *k = &data[1 + i * HID_COMMAND_KEYMAP_SIZE];
+                        if (k[0]) printf("%5u %3u %3u %04X\n", l, r, c, k[1] | k[2] << 8);
+                    }
+                }
+            }
+        }
+    }
+    else if (!strcmp(cmd, "keymap-set") && nargs == 4) {
+        unsigned entry = strtoul(args[3], NULL, 0);
+        for (int i = 0; i < 3; i++) buf[i] = strtoul(args[i], NULL, 0);
+        buf[3] = entry & 0xFF;
+        buf[4] = entry >> 8;
+        request(HID_COMMAND_KEYMAP_SET, buf, 5);
+    }
+    else if (!strcmp(cmd, "keymap-del") && nargs == 3) {
+        for (int i = 0; i < 3; i++) buf[i] = strtoul(args[i], NULL, 0);
+        request(HID_COMMAND_KEYMAP_DEL, buf, 3);
+    }
+    else if (!strcmp(cmd, "keymap-clear")) {
+        request(HID_COMMAND_KEYMAP_CLEAR, NULL, 0);
+    }
+    else {
+        usage(argv[0]);
+    }
+
+    close(fd);
+    return 0;
+}
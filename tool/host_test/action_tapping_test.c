@@ -0,0 +1,419 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Tap keys(common/action_tapping.c)
+ *
+ * Events are fed to action_tapping_process() and every process_action()
+ * call is logged. Columns 0 and 1 are tap keys, others plain keys.
+ *
+ * Classic mode(no strategy option) is checked against a hash of output of
+ * action_tapping.c before strategies were added, for random bursts of keys
+ * with TAPPING_TERM 200 and 600. Bursts fit in its waiting buffer of 8, so
+ * overflow handling is not part of the comparison.
+ *
+ * Overflow of the waiting buffer is tested with 20-key rolls while a tap key
+ * is held.
+ *
+ * Tap keys of row 0 to 5 are dual-role modifiers, of row 6 layer tap keys and
+ * of row 7 oneshot modifiers.
+ *
+ * Latency of home-row chords(dual-role modifier held while other key is
+ * typed) is measured from press of the other key to its process_action().
+ */
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+#include "action.h"
+#include "action_layer.h"
+#include "action_tapping.h"
+
+
+#if defined(PERMISSIVE_HOLD) || defined(HOLD_ON_OTHER_KEY_PRESS) || defined(RETRO_TAPPING) || \
+    defined(MODS_TAP_HOLD_ON_OTHER_KEY_PRESS)
+#define STRATEGY
+#endif
+
+/* dual-role modifier is decided as hold when other key is pressed */
+#if defined(HOLD_ON_OTHER_KEY_PRESS) || defined(MODS_TAP_HOLD_ON_OTHER_KEY_PRESS)
+#define MODS_HOLD_ON_PRESS
+#endif
+
+/* short log of process_action(): "<col><+|->[tap count]" */
+static char log_buf[4096];
+/* FNV-1a of every process_action() call */
+static uint32_t hash;
+static long actions;
+static long clears;
+
+/* chords: ms of scan, press of other key, sum of its latency and count */
+static bool chord_run;
+static uint32_t now;
+static uint32_t chord_time;
+static long chord_latency;
+static long chord_keys;
+static long chord_holds;
+
+static void hash_byte(uint8_t b)
+{
+    hash = (hash ^ b) * 16777619UL;
+}
+
+void process_action(keyrecord_t *record)
+{
+    keyevent_t e = record->event;
+    if (IS_NOEVENT(e)) return;
+
+    hash_byte(e.key.row); hash_byte(e.key.col); hash_byte(e.pressed);
+    hash_byte(e.time); hash_byte(e.time >> 8);
+    hash_byte(record->tap.count); hash_byte(record->tap.interrupted);
+    actions++;
+
+    if (chord_run && e.pressed) {
+        if (e.key.col == 3) {
+            chord_latency += now - chord_time;
+            chord_keys++;
+        } else if (!record->tap.count) {
+            chord_holds++;
+        }
+    }
+
+    size_t n = strlen(log_buf);
+    if (n + 8 > sizeof(log_buf)) return;
+    snprintf(log_buf + n, sizeof(log_buf) - n, "%s%d%c", n ? " " : "", e.key.col, e.pressed ? '+' : '-');
+    if (record->tap.count) {
+        n = strlen(log_buf);
+        snprintf(log_buf + n, sizeof(log_buf) - n, "%d", record->tap.count);
+    }
+}
+
+bool is_tap_key(keypos_t key)
+{
+    return key.col < 2;
+}
+
+action_t layer_switch_get_action(keypos_t key)
+{
+    if (key.col >= 2) return (action_t){ .code = ACTION_KEY(KC_B) };
+    switch (key.row) {
+        case 6:  return (action_t){ .code = ACTION_LAYER_TAP_KEY(1, KC_A) };
+        case 7:  return (action_t){ .code = ACTION_MODS_ONESHOT(MOD_LSFT) };
+        default: return (action_t){ .code = ACTION_MODS_TAP_KEY(MOD_LSFT, KC_A) };
+    }
+}
+
+void clear_keyboard(void)
+{
+    hash_byte(0xCC);
+    clears++;
+    size_t n = strlen(log_buf);
+    snprintf(log_buf + n, sizeof(log_buf) - n, "%sCLEAR", n ? " " : "");
+}
+
+void debug_event(keyevent_t event) {}
+void debug_record(keyrecord_t record) {}
+
+/* tap keys of row 1 have shorter term; random sequences use row 0 only */
+uint16_t get_tapping_term(keyevent_t event)
+{
+    return event.key.row == 1 ? 100 : TAPPING_TERM;
+}
+
+
+static void ev(uint8_t row, uint8_t col, bool pressed, uint16_t time)
+{
+    action_tapping_process((keyrecord_t){
+        .event = { .key = { .row = row, .col = col }, .pressed = pressed, .time = time | 1 }
+    });
+}
+
+/* matrix scan without change */
+static void tick(uint16_t time)
+{
+    action_tapping_process((keyrecord_t){
+        .event = { .key = { .row = 255, .col = 255 }, .pressed = false, .time = time | 1 }
+    });
+}
+
+/* log so far, while keys may still wait */
+static void expect_now(const char *name, const char *expected)
+{
+    if (strcmp(log_buf, expected)) {
+        printf("FAIL %s:\n  got      %s\n  expected %s\n", name, log_buf, expected);
+        host_failures++;
+    }
+}
+
+static void expect_log(const char *name, const char *expected)
+{
+    tick(60000);
+    expect_now(name, expected);
+    log_buf[0] = '\0';
+}
+
+
+static void test_tap(void)
+{
+    ev(0, 0, true, 10); ev(0, 0, false, 50);
+    expect_log("tap", "0+1 0-1");
+
+    ev(0, 0, true, 10); tick(TAPPING_TERM + 50); ev(0, 0, false, TAPPING_TERM + 100);
+#ifdef RETRO_TAPPING
+    expect_log("hold", "0+ 0- 0+1 0-1");
+#else
+    expect_log("hold", "0+ 0-");
+#endif
+}
+
+static void test_other_key(void)
+{
+    // other key typed while tap key is held
+    ev(0, 0, true, 10); ev(0, 3, true, 20);
+#ifdef MODS_HOLD_ON_PRESS
+    expect_now("typed, decided on press", "0+ 3+");
+#else
+    expect_now("typed, waiting", "");
+#endif
+    ev(0, 3, false, 30); ev(0, 0, false, 40);
+#if defined(PERMISSIVE_HOLD) || defined(MODS_HOLD_ON_PRESS) || TAPPING_TERM >= 500
+    expect_log("typed", "0+ 3+ 3- 0-");
+#else
+    expect_log("typed", "0+1 3+ 3- 0-1");
+#endif
+
+    // other key only pressed while tap key is held
+    ev(0, 0, true, 10); ev(0, 3, true, 20); ev(0, 0, false, 40); ev(0, 3, false, 50);
+#ifdef MODS_HOLD_ON_PRESS
+    expect_log("pressed", "0+ 3+ 0- 3-");
+#else
+    expect_log("pressed", "0+1 3+ 0-1 3-");
+#endif
+}
+
+/* layer tap key and oneshot modifier are not dual-role modifiers */
+static void test_other_tap_keys(void)
+{
+    static const char *name[] = { "layer tap", "oneshot" };
+    for (uint8_t row = 6; row <= 7; row++) {
+        ev(row, 0, true, 10); ev(0, 3, true, 20);
+#ifdef HOLD_ON_OTHER_KEY_PRESS
+        expect_now(name[row - 6], "0+ 3+");
+#else
+        expect_now(name[row - 6], "");
+#endif
+        ev(row, 0, false, 40); ev(0, 3, false, 50);
+#ifdef HOLD_ON_OTHER_KEY_PRESS
+        expect_log(name[row - 6], "0+ 3+ 0- 3-");
+#else
+        expect_log(name[row - 6], "0+1 3+ 0-1 3-");
+#endif
+    }
+}
+
+static void test_tapping_term(void)
+{
+    // get_tapping_term(): 100ms for row 1
+    ev(1, 0, true, 10); tick(130); ev(1, 0, false, 150);
+#ifdef RETRO_TAPPING
+    expect_log("term per key", "0+ 0- 0+1 0-1");
+#else
+    expect_log("term per key", "0+ 0-");
+#endif
+    ev(0, 0, true, 10); tick(130); ev(0, 0, false, 150);
+    expect_log("term default", "0+1 0-1");
+}
+
+/* key k of a roll: plain keys of rows 2 to 5 */
+static keypos_t roll_key(uint8_t k)
+{
+    return (keypos_t){ .row = 2 + (k - 1) / 6, .col = 2 + (k - 1) % 6 };
+}
+
+static void roll_ev(uint8_t k, bool pressed, uint16_t time, char *expected)
+{
+    keypos_t key = roll_key(k);
+    ev(key.row, key.col, pressed, time);
+    size_t n = strlen(expected);
+    sprintf(expected + n, " %d%c", key.col, pressed ? '+' : '-');
+}
+
+/* 20-key roll while tap key is held: waiting buffer overflows */
+static void test_roll(void)
+{
+    static char expected[sizeof(log_buf)];
+    uint16_t t = 1000;
+
+    for (uint8_t round = 0; round < 50; round++) {
+        strcpy(expected, "0+");
+        ev(0, 0, true, t++);
+        for (uint8_t k = 1; k <= 20; k++) {
+            roll_ev(k, true, t, expected); t += 3;
+            if (k > 2) { roll_ev(k - 2, false, t, expected); t += 2; }
+        }
+        roll_ev(19, false, t++, expected);
+        roll_ev(20, false, t++, expected);
+        ev(0, 0, false, t++);
+        strcat(expected, " 0-");
+        // tap key is settled as hold and every event goes through in order
+        expect_log("roll", expected);
+        t += 500;
+    }
+}
+
+
+/* Park-Miller: same sequences on every host */
+static uint32_t seed;
+static uint16_t rnd(uint16_t n)
+{
+    seed = (uint32_t)(((uint64_t)seed * 48271) % 2147483647);
+    return seed % n;
+}
+
+/* matrix scan every ms */
+static void scan_until(uint32_t time)
+{
+    while (now < time) tick(++now);
+}
+
+static void chord_ev(uint8_t col, bool pressed, uint32_t time)
+{
+    scan_until(time);
+    ev(0, col, pressed, time);
+}
+
+/* 1000 chords, then 1000 rolls meant as taps of modifier key */
+static void test_chords(void)
+{
+    seed = 1;
+    now = 100000;
+    chord_run = true;
+    for (int i = 0; i < 1000; i++) {
+        // modifier down, key typed 20-149ms later and held 40-119ms, modifier up 30ms after
+        uint32_t t = now + 50;
+        uint16_t d = 20 + rnd(130), h = 40 + rnd(80);
+        chord_ev(0, true, t);
+        chord_time = t + d;
+        chord_ev(3, true, t + d);
+        chord_ev(3, false, t + d + h);
+        chord_ev(0, false, t + d + h + 30);
+        scan_until(now + 400);
+    }
+    printf("  chords: %.1fms mean latency of key, %ld%% modifier hold\n",
+           (double)chord_latency / chord_keys, chord_holds / 10);
+    CHECK(chord_keys == 1000);
+#ifdef MODS_HOLD_ON_PRESS
+    CHECK(chord_latency == 0 && chord_holds == 1000);
+#endif
+
+    chord_latency = chord_keys = chord_holds = 0;
+    for (int i = 0; i < 1000; i++) {
+        // modifier tapped, key pressed 10-69ms after modifier and 5-44ms before its release
+        uint32_t t = now + 50;
+        uint16_t d = 10 + rnd(60), o = 5 + rnd(40);
+        chord_ev(0, true, t);
+        chord_time = t + d;
+        chord_ev(3, true, t + d);
+        chord_ev(0, false, t + d + o);
+        chord_ev(3, false, t + d + o + 40);
+        scan_until(now + 400);
+    }
+    printf("  rolls:  %.1fms mean latency of key, %ld%% modifier hold\n",
+           (double)chord_latency / chord_keys, chord_holds / 10);
+    CHECK(chord_keys == 1000);
+    chord_run = false;
+    log_buf[0] = '\0';
+}
+
+
+#ifndef STRATEGY
+
+/* hash of action_tapping.c before strategies and per-key term */
+#if TAPPING_TERM == 200
+#define CLASSIC_HASH    0xE5F187B3UL
+#elif TAPPING_TERM == 600
+#define CLASSIC_HASH    0xC384A99EUL
+#endif
+
+static void test_classic(void)
+{
+    hash = 2166136261UL;
+    actions = 0;
+    clears = 0;
+    for (uint32_t s = 1; s <= 200; s++) {
+        uint16_t t = 1;
+        seed = s;
+        for (uint16_t n = 0; n < 500; n++) {
+            // burst of keys all released at the end; fits in waiting buffer of 8
+            bool down[6] = {};
+            for (uint8_t i = rnd(4) + 1; i; i--) {
+                uint8_t c = rnd(6);
+                down[c] = !down[c];
+                ev(0, c, down[c], t += rnd(4) ? rnd(60) : rnd(400));
+                if (rnd(3) == 0) tick(t += rnd(60));
+            }
+            for (uint8_t c = 0; c < 6; c++) {
+                if (down[c]) ev(0, c, false, t += rnd(4) ? rnd(60) : rnd(400));
+            }
+            tick(t += rnd(2) ? rnd(300) : 1000);
+        }
+        tick(t + 1000);
+        log_buf[0] = '\0';
+    }
+    printf("  classic: %ld actions, %ld clears, hash %08lX\n", actions, clears, (unsigned long)hash);
+#ifdef CLASSIC_HASH
+    CHECK(hash == CLASSIC_HASH);
+#endif
+}
+#endif
+
+
+int main(void)
+{
+    printf("action_tapping: TAPPING_TERM %d%s%s%s%s\n", TAPPING_TERM,
+#ifdef PERMISSIVE_HOLD
+           " PERMISSIVE_HOLD",
+#else
+           "",
+#endif
+#ifdef HOLD_ON_OTHER_KEY_PRESS
+           " HOLD_ON_OTHER_KEY_PRESS",
+#else
+           "",
+#endif
+#ifdef RETRO_TAPPING
+           " RETRO_TAPPING",
+#else
+           "",
+#endif
+#ifdef MODS_TAP_HOLD_ON_OTHER_KEY_PRESS
+           " MODS_TAP_HOLD_ON_OTHER_KEY_PRESS"
+#else
+           ""
+#endif
+    );
+#ifndef STRATEGY
+    // first, as hash was taken from power on
+    test_classic();
+#endif
+    test_tap();
+    test_other_key();
+    test_other_tap_keys();
+    test_tapping_term();
+    test_roll();
+    test_chords();
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
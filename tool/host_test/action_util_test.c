@@ -0,0 +1,233 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Keys of 6KRO report(common/action_util.c)
+ *
+ * add_key()/del_key() are checked against a model which keeps held keys in
+ * order of press: report has the same keys without duplicates,
+ * has_anykey() is the count and get_first_key() the oldest. With
+ * USB_6KRO_ENABLE a seventh key pushes out the oldest, otherwise it is
+ * dropped.
+ *
+ * Each rollover pattern is also timed per add/del call. Timing is printed
+ * only, as it depends on the host.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+#include "action_util.h"
+
+
+static long sends;
+
+void host_keyboard_send(report_keyboard_t *report)
+{
+    sends++;
+}
+
+
+/* held keys in order of press, oldest first */
+static uint8_t model[KEYBOARD_REPORT_KEYS];
+static uint8_t model_count;
+
+static void model_add(uint8_t code)
+{
+    for (uint8_t i = 0; i < model_count; i++) {
+        if (model[i] == code) return;
+    }
+    if (model_count == KEYBOARD_REPORT_KEYS) {
+#ifdef USB_6KRO_ENABLE
+        memmove(model, model + 1, --model_count);
+#else
+        return;
+#endif
+    }
+    model[model_count++] = code;
+}
+
+static void model_del(uint8_t code)
+{
+    for (uint8_t i = 0; i < model_count; i++) {
+        if (model[i] == code) {
+            memmove(model + i, model + i + 1, --model_count - i);
+            return;
+        }
+    }
+}
+
+static void check_report(void)
+{
+    uint8_t n = 0;
+    bool ok = true;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t code = keyboard_report->keys[i];
+        if (!code) continue;
+        n++;
+        bool found = false;
+        for (uint8_t j = 0; j < model_count; j++) {
+            if (model[j] == code) found = true;
+        }
+        // keys of model are unique, so this also catches duplicates
+        ok = ok && found;
+    }
+    ok = ok && n == model_count && has_anykey() == model_count;
+    ok = ok && get_first_key() == (model_count ? model[0] : 0);
+    if (!ok) {
+        printf("FAIL report:");
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) printf(" %02X", keyboard_report->keys[i]);
+        printf(" first %02X, expected", get_first_key());
+        for (uint8_t i = 0; i < model_count; i++) printf(" %02X", model[i]);
+        printf("\n");
+        host_failures++;
+    }
+}
+
+static void press(uint8_t code)
+{
+    add_key(code);
+    model_add(code);
+    check_report();
+}
+
+static void release(uint8_t code)
+{
+    del_key(code);
+    model_del(code);
+    check_report();
+}
+
+
+/* Park-Miller: same sequences on every host */
+static uint32_t seed = 1;
+static uint16_t rnd(uint16_t n)
+{
+    seed = (uint32_t)(((uint64_t)seed * 48271) % 2147483647);
+    return seed % n;
+}
+
+static void test_random(void)
+{
+    bool down[16] = {};
+    for (long n = 0; n < 200000; n++) {
+        uint8_t k = rnd(16);
+        down[k] = !down[k];
+        if (down[k]) press(KC_A + k); else release(KC_A + k);
+        // keys pushed out of report are released by their own event later
+        if (rnd(1000) == 0) {
+            clear_keys();
+            model_count = 0;
+            memset(down, 0, sizeof(down));
+            check_report();
+        }
+    }
+}
+
+
+/* Rollover patterns
+ *
+ * Key j of a sequence is KC_A + j % 16. Each starts with the report full of
+ * keys 0 to 5 and step i goes on from there. Steps are run through press()
+ * and release() against model, then timed with add_key() and del_key().
+ */
+static void (*key_down)(uint8_t code);
+static void (*key_up)(uint8_t code);
+
+#define SEQ_KEY(j)  (KC_A + (j) % 16)
+
+/* release oldest, press next */
+static void roll(long i)
+{
+    long j = i + KEYBOARD_REPORT_KEYS;
+    key_up(SEQ_KEY(j - KEYBOARD_REPORT_KEYS));
+    key_down(SEQ_KEY(j));
+}
+
+/* KC_A is held and others roll: release next to oldest */
+static void roll_held(long i)
+{
+    long j = i + KEYBOARD_REPORT_KEYS - 1;
+    key_up(KC_B + (j - (KEYBOARD_REPORT_KEYS - 1)) % 15);
+    key_down(KC_B + j % 15);
+}
+
+/* release and press newest again */
+static void repeat_newest(long i)
+{
+    key_up(SEQ_KEY(KEYBOARD_REPORT_KEYS - 1));
+    key_down(SEQ_KEY(KEYBOARD_REPORT_KEYS - 1));
+}
+
+/* press one more key than report holds */
+static void overflow(long i)
+{
+    key_down(SEQ_KEY(i + KEYBOARD_REPORT_KEYS));
+}
+
+static void fill(void)
+{
+    clear_keys();
+    model_count = 0;
+    for (uint8_t j = 0; j < KEYBOARD_REPORT_KEYS; j++) key_down(SEQ_KEY(j));
+}
+
+static void pattern(const char *name, void (*step)(long), uint8_t calls)
+{
+    enum { STEPS = 2000000 };
+    struct timespec t0, t1;
+
+    key_down = press;
+    key_up = release;
+    fill();
+    for (long i = 0; i < 1000; i++) step(i);
+
+    key_down = add_key;
+    key_up = del_key;
+    fill();
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (long i = 0; i < STEPS; i++) step(i);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    printf("  %-16s %5.1f ns/call\n", name, ns / STEPS / calls);
+    CHECK(has_anykey() == KEYBOARD_REPORT_KEYS);
+    clear_keys();
+    model_count = 0;
+}
+
+static void test_patterns(void)
+{
+    pattern("roll", roll, 2);
+    pattern("roll, one held", roll_held, 2);
+    pattern("repeat newest", repeat_newest, 2);
+    pattern("overflow", overflow, 1);
+}
+
+
+int main(void)
+{
+    printf("action_util: %d keys%s\n", KEYBOARD_REPORT_KEYS,
+#ifdef USB_6KRO_ENABLE
+           " USB_6KRO_ENABLE"
+#else
+           ""
+#endif
+    );
+    test_random();
+    test_patterns();
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
@@ -0,0 +1,172 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Combo(common/combo.c)
+ *
+ * 200000 random events of typing with overlaps and deliberate chords go
+ * through combo_event(), with combo_task() on every ms scan between them.
+ * Events passed to action_exec() are checked:
+ *   - press of key which is member of no combo is passed at once
+ *   - press of member key and fired combo come within the longest term plus
+ *     one scan
+ *   - no key is pressed twice, released when up or left down at the end
+ *   - time of events never goes backwards
+ */
+#include <stdio.h>
+#include "host.h"
+#include "combo.h"
+
+
+/* keys are numbered row * 8 + col; key 11 is row 1 col 3 */
+const combo_t combos[COMBO_COUNT] PROGMEM = {
+    COMBO(ACTION_KEY(KC_ESC), COMBO_KEY(0, 0), COMBO_KEY(0, 1)),
+    COMBO(ACTION_KEY(KC_TAB), COMBO_KEY(0, 1), COMBO_KEY(0, 2)),
+    COMBO_TERM_MS(80, ACTION_KEY(KC_ENT), COMBO_KEY(0, 0), COMBO_KEY(0, 1), COMBO_KEY(0, 2)),
+    COMBO(ACTION_KEY(KC_BSPC), COMBO_KEY(0, 3), COMBO_KEY(1, 3)),
+};
+#define MAX_TERM    80
+
+static bool is_member(uint8_t k)
+{
+    return k < 4 || k == 11;
+}
+
+/* ms of scan */
+static uint32_t now;
+
+/* output: down state of matrix keys and of virtual keys of combos(64 up) */
+static bool down[64 + COMBO_COUNT];
+static uint32_t pressed_at[64];
+static uint32_t last_member_press;
+static uint16_t last_time;
+static long passed[2], latency_sum[2], latency_max[2];
+static long fired, fired_latency_sum, fired_latency_max;
+
+void action_exec(keyevent_t e)
+{
+    uint8_t k = IS_COMBO_KEY(e.key) ? 64 + e.key.col : e.key.row * 8 + e.key.col;
+
+    if ((int16_t)(e.time - last_time) < 0) {
+        printf("FAIL time goes back: key %d at %lu\n", k, (unsigned long)now);
+        host_failures++;
+    }
+    last_time = e.time;
+    if (e.pressed == down[k]) {
+        printf("FAIL key %d %s twice at %lu\n", k, e.pressed ? "pressed" : "released", (unsigned long)now);
+        host_failures++;
+    }
+    down[k] = e.pressed;
+    if (!e.pressed) return;
+
+    if (IS_COMBO_KEY(e.key)) {
+        long l = now - last_member_press;
+        fired++;
+        fired_latency_sum += l;
+        if (l > fired_latency_max) fired_latency_max = l;
+        return;
+    }
+    CHECK(e.time == (uint16_t)(pressed_at[k] | 1));
+    long l = now - pressed_at[k];
+    uint8_t m = is_member(k);
+    passed[m]++;
+    latency_sum[m] += l;
+    if (l > latency_max[m]) latency_max[m] = l;
+}
+
+
+static bool phys[16];
+
+static void scan_until(uint32_t t)
+{
+    while (now < t) {
+        host_time = ++now;
+        combo_task();
+    }
+}
+
+static void ev(uint8_t k, bool pressed, uint32_t t)
+{
+    scan_until(t);
+    if (phys[k] == pressed) return;
+    phys[k] = pressed;
+    if (pressed) {
+        pressed_at[k] = now;
+        if (is_member(k)) last_member_press = now;
+    }
+    combo_event((keyevent_t){ .key = { .row = k / 8, .col = k % 8 }, .pressed = pressed, .time = (uint16_t)now | 1 });
+}
+
+
+/* Park-Miller: same sequences on every host */
+static uint32_t seed = 7;
+static uint16_t rnd(uint16_t n)
+{
+    seed = (uint32_t)(((uint64_t)seed * 48271) % 2147483647);
+    return seed % n;
+}
+
+int main(void)
+{
+    static const uint8_t keys[] = { 0, 1, 2, 3, 11, 4, 5, 6, 7 };
+
+    printf("combo: %d combos, COMBO_TERM %d\n", COMBO_COUNT, COMBO_TERM);
+    combo_init();
+    now = 1;
+    for (long n = 0; n < 200000; n++) {
+        uint32_t t = now + 1 + rnd(120);
+        if (rnd(6) == 0) {
+            // chord of two or three keys of the first three
+            uint8_t a = rnd(3), b = (a + 1) % 3;
+            ev(a, true, t);
+            ev(b, true, t + rnd(25));
+            if (rnd(3) == 0) ev(2, true, now + rnd(40));
+            ev(a, false, now + 30 + rnd(150));
+            ev(b, false, now + rnd(30));
+            ev(2, false, now + rnd(30));
+            continue;
+        }
+        uint8_t k = keys[rnd(9)];
+        ev(k, !phys[k], t);
+        if (rnd(4) == 0) {
+            for (uint8_t j = 0; j < sizeof(keys); j++) {
+                if (phys[keys[j]]) ev(keys[j], false, now + rnd(20));
+            }
+        }
+    }
+    for (uint8_t k = 0; k < 16; k++) ev(k, false, now + 1);
+    scan_until(now + 200);
+    for (uint8_t k = 0; k < sizeof(down); k++) {
+        if (down[k]) {
+            printf("FAIL key %d stuck\n", k);
+            host_failures++;
+        }
+    }
+
+    printf("  non-member presses %ld: %.2fms mean, %ldms max\n", passed[0],
+           (double)latency_sum[0] / passed[0], latency_max[0]);
+    printf("  member presses passed %ld: %.2fms mean, %ldms max\n", passed[1],
+           (double)latency_sum[1] / passed[1], latency_max[1]);
+    printf("  combos fired %ld: %.2fms mean, %ldms max after last key\n", fired,
+           (double)fired_latency_sum / fired, fired_latency_max);
+    CHECK(latency_max[0] == 0);
+    CHECK(latency_max[1] <= MAX_TERM + 1);
+    CHECK(fired_latency_max <= MAX_TERM + 1);
+    CHECK(passed[1] && fired);
+
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
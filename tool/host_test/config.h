@@ -0,0 +1,8 @@
+/* keyboard config for host tests */
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#define MATRIX_ROWS 8
+#define MATRIX_COLS 8
+
+#endif
@@ -0,0 +1,14 @@
+/* host stub of avr-libc <avr/eeprom.h>: EEPROM emulated in RAM by host.c */
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "avr/io.h"
+
+uint8_t eeprom_read_byte(const uint8_t *p);
+void eeprom_update_byte(uint8_t *p, uint8_t value);
+void eeprom_read_block(void *dst, const void *src, unsigned n);
+#define eeprom_is_ready()   true
+
+#endif
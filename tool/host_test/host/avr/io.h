@@ -0,0 +1,10 @@
+/* host stub of avr-libc <avr/io.h> */
+#ifndef IO_H
+#define IO_H
+
+#include <stdint.h>
+
+/* ATmega32U4 */
+#define E2END   0x3FF
+
+#endif
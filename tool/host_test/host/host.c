@@ -0,0 +1,46 @@
+/* emulated EEPROM and timer for host tests */
+#include <string.h>
+#include "avr/eeprom.h"
+#include "timer.h"
+#include "host.h"
+
+
+uint8_t host_eeprom[E2END + 1];
+long host_eeprom_writes = 0;
+long host_eeprom_budget = -1;
+long host_eeprom_lost = 0;
+uint16_t host_time = 0;
+int host_failures = 0;
+
+
+uint8_t eeprom_read_byte(const uint8_t *p)
+{
+    return host_eeprom[(uintptr_t)p];
+}
+
+void eeprom_update_byte(uint8_t *p, uint8_t value)
+{
+    if (host_eeprom[(uintptr_t)p] == value) return;
+    if (host_eeprom_budget == 0) {
+        host_eeprom_lost++;
+        return;
+    }
+    if (host_eeprom_budget > 0) host_eeprom_budget--;
+    host_eeprom[(uintptr_t)p] = value;
+    host_eeprom_writes++;
+}
+
+void eeprom_read_block(void *dst, const void *src, unsigned n)
+{
+    memcpy(dst, &host_eeprom[(uintptr_t)src], n);
+}
+
+uint16_t timer_read(void)
+{
+    return host_time;
+}
+
+uint16_t timer_elapsed(uint16_t last)
+{
+    return host_time - last;
+}
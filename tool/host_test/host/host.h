@@ -0,0 +1,24 @@
+/* emulated EEPROM and timer for host tests */
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+/* firmware modules include host.h of common/ by this name */
+#include_next "host.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "avr/io.h"
+
+extern uint8_t host_eeprom[E2END + 1];
+extern long host_eeprom_writes;     /* bytes changed by eeprom_update_byte */
+extern long host_eeprom_budget;     /* writes left before power is cut, -1 for no limit */
+extern long host_eeprom_lost;       /* writes after power is cut */
+extern uint16_t host_time;          /* ms returned by timer_read */
+
+extern int host_failures;
+#define CHECK(x) do { \
+    if (!(x)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #x); host_failures++; } \
+} while (0)
+
+#endif
@@ -0,0 +1,216 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Key repeat in firmware(common/key_repeat.c)
+ *
+ * Key is added to report with add_key() of common/action_util.c and
+ * key_repeat_task() runs on every scan of 1 to 3ms. Host sees a press of
+ * the key whenever a report has it after one without it.
+ *
+ * With KEY_REPEAT_REFRESH a part of reports is lost on the way to host and
+ * time the host has wrong state of the key is measured.
+ */
+#include <stdio.h>
+#include "host.h"
+#include "action_util.h"
+#include "key_repeat.h"
+
+
+/* Park-Miller: same sequences on every host */
+static uint32_t seed = 3;
+static uint16_t rnd(uint16_t n)
+{
+    seed = (uint32_t)(((uint64_t)seed * 48271) % 2147483647);
+    return seed % n;
+}
+
+static uint32_t now;
+static uint8_t drop_percent;
+
+/* host side */
+static bool host_has_key;
+static long presses;
+static uint32_t last_press;
+static long interval_count;
+static uint32_t interval_sum, interval_min, interval_max;
+
+void host_keyboard_send(report_keyboard_t *report)
+{
+    if (rnd(100) < drop_percent) return;
+
+    bool has = false;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (report->keys[i] == KC_A) has = true;
+    }
+    if (has && !host_has_key) {
+        if (presses >= 2) {
+            uint32_t d = now - last_press;
+            interval_sum += d;
+            interval_count++;
+            if (d < interval_min) interval_min = d;
+            if (d > interval_max) interval_max = d;
+        }
+        presses++;
+        last_press = now;
+    }
+    host_has_key = has;
+}
+
+static void reset_host(void)
+{
+    host_has_key = false;
+    presses = 0;
+    interval_count = interval_sum = interval_max = 0;
+    interval_min = UINT32_MAX;
+}
+
+
+/* physical state of key and how long host has had it wrong */
+static bool key_down;
+static uint32_t wrong_since, wrong_max, wrong_total;
+static long wrong_count;
+
+static void scan_until(uint32_t t)
+{
+    while (now < t) {
+        now += 1 + rnd(3);
+        host_time = now;
+        key_repeat_task();
+
+        bool wrong = (host_has_key != key_down);
+        if (wrong && !wrong_since) wrong_since = now;
+        if (!wrong && wrong_since) {
+            uint32_t d = now - wrong_since;
+            wrong_total += d;
+            wrong_count++;
+            if (d > wrong_max) wrong_max = d;
+            wrong_since = 0;
+        }
+    }
+}
+
+static void press(void)
+{
+    key_down = true;
+    add_key(KC_A);
+    send_keyboard_report();
+}
+
+static void release(void)
+{
+    key_down = false;
+    del_key(KC_A);
+    send_keyboard_report();
+}
+
+
+/* key held 10s: first repeat after delay, then at interval */
+static void test_rate(void)
+{
+    reset_host();
+    scan_until(now + 100);
+    uint32_t t0 = now;
+    press();
+    scan_until(t0 + 10000);
+    release();
+
+    double expected = 1 + (10000.0 - KEY_REPEAT_DELAY) / KEY_REPEAT_INTERVAL;
+    printf("  hold 10s: %ld presses(%.1f expected), interval %lu to %lums, %.2fms mean\n",
+           presses, expected, (unsigned long)interval_min, (unsigned long)interval_max,
+           (double)interval_sum / interval_count);
+    CHECK(presses >= (long)expected - 1 && presses <= (long)expected + 1);
+    // scans of up to 3ms move each repeat, but the next one is due from when this one was
+    CHECK(interval_min >= KEY_REPEAT_INTERVAL - 3 && interval_max <= KEY_REPEAT_INTERVAL + 3);
+    CHECK(interval_sum / interval_count == KEY_REPEAT_INTERVAL);
+}
+
+static void test_first_repeat(void)
+{
+    reset_host();
+    scan_until(now + 100);
+    uint32_t t0 = now;
+    press();
+    while (presses < 2) scan_until(now + 1);
+    uint32_t first = now - t0;
+    release();
+    printf("  first repeat after %lums\n", (unsigned long)first);
+    CHECK(first >= KEY_REPEAT_DELAY && first <= KEY_REPEAT_DELAY + 3);
+}
+
+/* no scan for 200ms, e.g. blocked on a report which didn't go through */
+static void test_stall(void)
+{
+    reset_host();
+    scan_until(now + 100);
+    press();
+    scan_until(now + KEY_REPEAT_DELAY + 100);
+
+    long before = presses;
+    now += 200;
+    host_time = now;
+    key_repeat_task();
+    uint32_t resumed = now;
+    CHECK(presses == before + 1);
+
+    // one repeat on resume, then a whole interval to the next
+    while (presses == before + 1) scan_until(now + 1);
+    uint32_t gap = now - resumed;
+    release();
+    printf("  stall 200ms: 1 repeat on resume, next after %lums\n", (unsigned long)gap);
+    CHECK(gap >= KEY_REPEAT_INTERVAL && gap <= KEY_REPEAT_INTERVAL + 3);
+}
+
+#if KEY_REPEAT_REFRESH > 0
+/* taps and holds with 20% of reports lost */
+static void test_lossy(void)
+{
+    reset_host();
+    drop_percent = 20;
+    wrong_max = wrong_total = wrong_count = 0;
+    uint32_t t0 = now;
+    for (int i = 0; i < 5000; i++) {
+        scan_until(now + 20 + rnd(200));
+        press();
+        scan_until(now + 30 + rnd(rnd(4) ? 150 : 1500));
+        release();
+    }
+    scan_until(now + 1000);
+    drop_percent = 0;
+    printf("  20%% of reports lost: host wrong %ld times, %.1fms mean, %lums max, %.2f%% of time\n",
+           wrong_count, (double)wrong_total / wrong_count, (unsigned long)wrong_max,
+           100.0 * wrong_total / (now - t0));
+    // refresh sends state at least every KEY_REPEAT_REFRESH; some are lost in a row
+    CHECK(wrong_max <= 10 * KEY_REPEAT_REFRESH);
+    CHECK(!wrong_since);
+}
+#endif
+
+
+int main(void)
+{
+    printf("key_repeat: delay %d interval %d refresh %d\n",
+           KEY_REPEAT_DELAY, KEY_REPEAT_INTERVAL, KEY_REPEAT_REFRESH);
+    now = 1;
+    test_rate();
+    test_first_repeat();
+    test_stall();
+#if KEY_REPEAT_REFRESH > 0
+    test_lossy();
+#endif
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
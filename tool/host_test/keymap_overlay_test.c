@@ -0,0 +1,287 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Keymap overlay(common/keymap_overlay.c) on emulated EEPROM
+ *
+ * Source is included to reset its state as at power on. Power loss is
+ * emulated by a budget of EEPROM writes; after every possible cut the
+ * overlay loaded at next boot must have each key old or new, or back to
+ * flash while its entry is rewritten, and never a mixed entry.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "keycode.h"
+#include "keymap.h"
+#include "../../common/keymap_overlay.c"
+
+
+/* keymap in flash: 'A' on layer 0, transparent above */
+#ifdef ACTIONMAP_ENABLE
+const uint16_t actionmaps[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = { [0] = { ACTION_KEY(KC_A), ACTION_KEY(KC_A) } },
+};
+#define ENTRY(kc)       ACTION_KEY(kc)
+#define ENTRY_FN0       ACTIONMAP_FN(KC_FN0)
+#define WIDE(n)         (n)
+#else
+uint8_t keymap_key_to_keycode(uint8_t layer, keypos_t key)
+{
+    return layer == 0 && key.row == 0 && key.col < 2 ? KC_A : KC_TRNS;
+}
+#define ENTRY(kc)       (kc)
+#define ENTRY_FN0       KC_FN0
+#define WIDE(n)         ((n) & 0xFF)
+#endif
+
+action_t keymap_fn_to_action(uint8_t keycode)
+{
+    return (action_t){ .code = ACTION_LAYER_MOMENTARY(1) };
+}
+
+
+typedef struct {
+    matrix_row_t bitmap[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS];
+    keymap_overlay_t entries[KEYMAP_OVERLAY_LAYERS][MATRIX_ROWS][MATRIX_COLS];
+} snapshot_t;
+
+static keypos_t K(uint8_t row, uint8_t col)
+{
+    return (keypos_t){ .row = row, .col = col };
+}
+
+static void snapshot(snapshot_t *s)
+{
+    memcpy(s->bitmap, keymap_overlay_bitmap, sizeof(s->bitmap));
+    memcpy(s->entries, keymap_overlay_entries, sizeof(s->entries));
+}
+
+static bool snapshot_has(const snapshot_t *s, uint8_t l, keypos_t k)
+{
+    return s->bitmap[l][k.row] & ((matrix_row_t)1<<k.col);
+}
+
+/* RAM is lost: state as at power on */
+static void reboot(void)
+{
+    memset(keymap_overlay_bitmap, 0, sizeof(keymap_overlay_bitmap));
+    memset(keymap_overlay_entries, 0, sizeof(keymap_overlay_entries));
+    memset(dirty, 0, sizeof(dirty));
+    pending = false;
+    header_ok = false;
+    save_layer = NONE;
+    header_pos = 0;
+    keymap_overlay_init();
+}
+
+/* runs task until everything is saved */
+static void save(void)
+{
+    for (long n = 0; keymap_overlay_dirty() && n < 100000; n++) {
+        host_time++;
+        keymap_overlay_task();
+    }
+}
+
+/* saves with power cut after 'budget' writes; false if save completed */
+static bool save_cut(long budget)
+{
+    host_eeprom_budget = budget;
+    host_eeprom_lost = 0;
+    save();
+    host_eeprom_budget = -1;
+    return host_eeprom_lost;
+}
+
+static uint16_t count_keys(void)
+{
+    uint16_t n = 0;
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++)
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++)
+            for (uint8_t c = 0; c < MATRIX_COLS; c++)
+                n += keymap_overlay_has(l, K(r, c));
+    return n;
+}
+
+/* loaded overlay has every key old or new, or back to flash while it was being rewritten */
+static uint16_t broken_keys(const snapshot_t *o, const snapshot_t *n)
+{
+    uint16_t broken = 0;
+    for (uint8_t l = 0; l < KEYMAP_OVERLAY_LAYERS; l++) {
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            for (uint8_t c = 0; c < MATRIX_COLS; c++) {
+                keypos_t k = K(r, c);
+                bool has = keymap_overlay_has(l, k);
+                keymap_overlay_t v = keymap_overlay_get(l, k);
+                bool is_old = has == snapshot_has(o, l, k) && (!has || v == o->entries[l][r][c]);
+                bool is_new = has == snapshot_has(n, l, k) && (!has || v == n->entries[l][r][c]);
+                bool rewriting = !has && snapshot_has(o, l, k) && snapshot_has(n, l, k);
+                if (!is_old && !is_new && !rewriting) broken++;
+            }
+        }
+    }
+    return broken;
+}
+
+
+static void test_lookup(void)
+{
+    memset(host_eeprom, 0xFF, sizeof(host_eeprom));
+    reboot();
+    CHECK(!header_ok);
+    CHECK(action_for_key(0, K(0, 0)).code == ACTION_KEY(KC_A));
+
+    CHECK(keymap_overlay_set(0, K(0, 0), ENTRY(KC_B)));
+    CHECK(keymap_overlay_set(1, K(0, 0), ENTRY_FN0));
+    CHECK(!keymap_overlay_set(KEYMAP_OVERLAY_LAYERS, K(0, 0), ENTRY(KC_B)));
+    CHECK(!keymap_overlay_set(0, K(MATRIX_ROWS, 0), ENTRY(KC_B)));
+    CHECK(action_for_key(0, K(0, 0)).code == ACTION_KEY(KC_B));
+    CHECK(action_for_key(1, K(0, 0)).code == ACTION_LAYER_MOMENTARY(1));
+    CHECK(action_for_key(0, K(0, 1)).code == ACTION_KEY(KC_A));
+    CHECK(keymap_overlay_layers(K(0, 0)) == 3);
+
+    CHECK(keymap_overlay_del(0, K(0, 0)));
+    CHECK(action_for_key(0, K(0, 0)).code == ACTION_KEY(KC_A));
+    keymap_overlay_clear();
+    CHECK(count_keys() == 0);
+}
+
+static void test_save(void)
+{
+    memset(host_eeprom, 0xFF, sizeof(host_eeprom));
+    reboot();
+    CHECK(keymap_overlay_set(0, K(0, 0), ENTRY(KC_ESC)));
+    CHECK(keymap_overlay_set(1, K(7, 7), ENTRY(KC_A)));
+    CHECK(keymap_overlay_set(0, K(3, 5), ENTRY(KC_NO)));
+
+    // nothing is written until no change is made for the delay
+    host_eeprom_writes = 0;
+    for (uint16_t i = 0; i < KEYMAP_OVERLAY_SAVE_DELAY - 1; i++) {
+        host_time++;
+        keymap_overlay_task();
+    }
+    CHECK(host_eeprom_writes == 0);
+    save();
+    printf("  first save on erased EEPROM: %ld writes\n", host_eeprom_writes);
+
+    snapshot_t before, after;
+    snapshot(&before);
+    reboot();
+    snapshot(&after);
+    CHECK(header_ok);
+    CHECK(!memcmp(before.bitmap, after.bitmap, sizeof(before.bitmap)));
+    CHECK(keymap_overlay_get(0, K(0, 0)) == ENTRY(KC_ESC));
+    CHECK(keymap_overlay_get(1, K(7, 7)) == ENTRY(KC_A));
+    CHECK(keymap_overlay_has(0, K(3, 5)));
+
+    // many edits of a key within the delay are saved once
+    host_eeprom_writes = 0;
+    for (uint8_t i = 0; i < 50; i++) {
+        keymap_overlay_set(0, K(2, 2), ENTRY(i & 1 ? KC_B : KC_C));
+        host_time += 10;
+    }
+    save();
+    printf("  50 edits of a key: %ld writes\n", host_eeprom_writes);
+    CHECK(host_eeprom_writes <= ENTRY_BYTES + 1);
+
+    // saving what is already saved writes nothing
+    host_eeprom_writes = 0;
+    keymap_overlay_set(0, K(2, 2), ENTRY(KC_B));
+    save();
+    CHECK(host_eeprom_writes == 0);
+}
+
+static void test_power_loss(void)
+{
+    uint8_t image[sizeof(host_eeprom)];
+    snapshot_t old, new;
+    uint16_t broken = 0;
+    long cut = 0;
+
+    reboot();
+    snapshot(&old);
+    memcpy(image, host_eeprom, sizeof(image));
+    for (;; cut++) {
+        memcpy(host_eeprom, image, sizeof(image));
+        reboot();
+        keymap_overlay_del(0, K(0, 0));
+        keymap_overlay_set(0, K(0, 1), ENTRY(KC_D));
+        keymap_overlay_set(1, K(7, 7), WIDE(0x1234));    // both bytes change with actionmap
+        keymap_overlay_set(1, K(4, 0), ENTRY(KC_E));
+        snapshot(&new);
+        bool cut_off = save_cut(cut);
+        reboot();
+        broken += broken_keys(&old, &new);
+        if (!cut_off) {
+            CHECK(!memcmp(new.bitmap, keymap_overlay_bitmap, sizeof(new.bitmap)));
+            break;
+        }
+    }
+    printf("  power cut at each of %ld writes: %u broken keys\n", cut, broken);
+    CHECK(broken == 0);
+
+    host_eeprom_writes = 0;
+    keymap_overlay_clear();
+    save();
+    reboot();
+    CHECK(header_ok);
+    CHECK(count_keys() == 0);
+}
+
+static void test_garbage(void)
+{
+    uint8_t image[sizeof(host_eeprom)];
+    uint16_t broken = 0;
+    long cut = 0;
+
+    srand(1);
+    for (uint16_t i = 0; i < sizeof(host_eeprom); i++) host_eeprom[i] = rand();
+    reboot();
+    CHECK(!header_ok);
+    CHECK(count_keys() == 0);
+
+    memcpy(image, host_eeprom, sizeof(image));
+    for (;; cut++) {
+        memcpy(host_eeprom, image, sizeof(image));
+        reboot();
+        keymap_overlay_set(0, K(1, 1), ENTRY(KC_F));
+        bool cut_off = save_cut(cut);
+        reboot();
+        if (!cut_off) {
+            CHECK(count_keys() == 1);
+            CHECK(keymap_overlay_get(0, K(1, 1)) == ENTRY(KC_F));
+            break;
+        }
+        if (count_keys()) broken++;
+    }
+    printf("  power cut at each of %ld writes of first save on garbage: %u loaded\n", cut, broken);
+    CHECK(broken == 0);
+}
+
+
+int main(void)
+{
+    printf("keymap_overlay: %u layers, %u byte entries, image %u bytes\n",
+           KEYMAP_OVERLAY_LAYERS, (unsigned)ENTRY_BYTES, IMAGE_SIZE);
+    test_lookup();
+    test_save();
+    test_power_loss();
+    test_garbage();
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
@@ -0,0 +1,189 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Steno(common/steno.c)
+ *
+ * Dictionary is tool/steno/example.txt compiled by tool/steno. Chords are
+ * stroked with steno_key() and steno_task() runs every ms. Reports sent to
+ * host are decoded back into text with US layout, so the text, the pace of
+ * reports and throughput are checked from the host side.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "host.h"
+#include "action_util.h"
+#include "steno.h"
+
+
+/* bits of keys in example.txt */
+enum { S_ = 0, T_ = 1, K_ = 2, W_ = 4, H_ = 5, R_ = 6, A_ = 7, STAR = 9, _E = 10, _L = 16, _P = 14, _T = 18, _S = 19 };
+#define B(bit)  (1UL<<(bit))
+
+static uint32_t now;
+
+/* host side */
+static char out[1<<16];
+static unsigned out_len;
+static uint8_t prev_keys[KEYBOARD_REPORT_KEYS];
+static long reports;
+static uint32_t last_report;
+static uint32_t min_gap = UINT32_MAX;
+
+static char key_to_char(uint8_t key, bool shift)
+{
+    static const char normal[] = "1234567890\n\0\b\t -=[]\\\0;'`,./";
+    static const char shifted[] = "!@#$%^&*()\n\0\b\t _+{}|\0:\"~<>?";
+    if (key >= KC_A && key <= KC_Z) return (shift ? 'A' : 'a') + key - KC_A;
+    if (key >= KC_1 && key <= KC_SLSH) return (shift ? shifted : normal)[key - KC_1];
+    return 0;
+}
+
+void host_keyboard_send(report_keyboard_t *report)
+{
+    if (reports) {
+        uint32_t gap = now - last_report;
+        if (gap < min_gap) min_gap = gap;
+    }
+    reports++;
+    last_report = now;
+
+    bool shift = report->mods & MOD_BIT(KC_LSHIFT);
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = report->keys[i];
+        if (!key || memchr(prev_keys, key, sizeof(prev_keys))) continue;
+        char c = key_to_char(key, shift);
+        CHECK(c);
+        if (out_len < sizeof(out)) out[out_len++] = c;
+    }
+    memcpy(prev_keys, report->keys, sizeof(prev_keys));
+}
+
+
+static void stroke(uint32_t chord)
+{
+    for (uint8_t b = 0; b < 32; b++) {
+        if (chord & B(b)) steno_key(b, true);
+    }
+    for (uint8_t b = 0; b < 32; b++) {
+        if (chord & B(b)) steno_key(b, false);
+    }
+}
+
+static void run_until_idle(void)
+{
+    do {
+        host_time = ++now;
+        steno_task();
+    } while (steno_busy());
+}
+
+static void expect_text(const char *name, const char *expected)
+{
+    run_until_idle();
+    if (out_len != strlen(expected) || memcmp(out, expected, out_len)) {
+        printf("FAIL %s: got \"%.*s\"\n", name, (int)out_len, out);
+        host_failures++;
+    }
+    out_len = 0;
+}
+
+static void test_words(void)
+{
+    stroke(B(T_) | B(_E) | B(_S) | B(_T));
+    expect_text("test", "test ");
+
+    // Shift, repeated key and newline
+    stroke(B(S_) | B(K_) | B(W_) | B(R_));
+    expect_text("hello", "Hello, World!\n");
+
+    // keys pressed one after another make one chord until all are released
+    steno_key(T_, true); steno_key(H_, true); steno_key(T_, false);
+    host_time = ++now; steno_task();
+    steno_key(H_, false);
+    expect_text("chord", "the ");
+
+    // words queued in a row, and backspace
+    stroke(B(A_)); stroke(B(H_) | B(_E) | B(_L) | B(_P)); stroke(B(STAR));
+    expect_text("queued", "a help \b");
+
+    // chord not in dictionary types nothing
+    stroke(B(S_) | B(T_));
+    expect_text("not found", "");
+
+    // Shift and all keys are released at the end
+    CHECK(!prev_keys[0] && !get_weak_mods());
+}
+
+
+/* Park-Miller: same sequences on every host */
+static uint32_t seed = 5;
+static uint16_t rnd(uint16_t n)
+{
+    seed = (uint32_t)(((uint64_t)seed * 48271) % 2147483647);
+    return seed % n;
+}
+
+/* random words of dictionary, next stroked when previous one starts */
+static void test_throughput(void)
+{
+    static char expected[sizeof(out)];
+    unsigned expected_len = 0, typing = 0;
+    uint16_t words = 0;
+    uint16_t offsets[256];
+
+    for (uint16_t i = 0; i < steno_dict_size && words < 256; i++) {
+        if (steno_dict_slots[i] != STENO_DICT_EMPTY) offsets[words++] = steno_dict_slots[i];
+    }
+
+    reports = 0;
+    min_gap = UINT32_MAX;
+    uint32_t start = now;
+    for (int n = 0; n < 2000; n++) {
+        while (out_len < typing && now - start < 1000000UL) {
+            host_time = ++now;
+            steno_task();
+        }
+        const uint8_t *e = &steno_dict_entries[offsets[rnd(words)]];
+        uint32_t chord = e[0] | e[1] << 8 | (uint32_t)e[2] << 16 | (uint32_t)e[3] << 24;
+        stroke(chord);
+        typing = expected_len;
+        memcpy(&expected[expected_len], &e[5], e[4]);
+        expected_len += e[4];
+    }
+    run_until_idle();
+    uint32_t elapsed = last_report - start;
+
+    printf("  %u chars in %lums: %.0f chars/s, %.2f reports/char, reports %lums apart at least\n",
+           expected_len, (unsigned long)elapsed, expected_len * 1000.0 / elapsed,
+           (double)reports / expected_len, (unsigned long)min_gap);
+    CHECK(out_len == expected_len && !memcmp(out, expected, out_len));
+    CHECK(min_gap >= STENO_REPORT_INTERVAL);
+    // a report per character and a few more for Shift and repeated keys
+    CHECK(reports <= expected_len * 3 / 2);
+    out_len = 0;
+}
+
+
+int main(void)
+{
+    printf("steno: STENO_REPORT_INTERVAL %d, %d slots\n", STENO_REPORT_INTERVAL, steno_dict_size);
+    now = 1000;
+    test_words();
+    test_throughput();
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
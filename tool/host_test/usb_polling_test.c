@@ -0,0 +1,214 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Interrupt IN endpoint of LUFA HID(protocol/lufa) at USB level
+ *
+ * LUFA can't be built for host, so this is a model of it in us:
+ *   - host takes one bank every USB_POLLING_INTERVAL ms, from a random phase
+ *   - send_keyboard() writes a report into a free bank, or busy-waits 255
+ *     times _delay_us(4 * USB_POLLING_INTERVAL) for one and drops the
+ *     report after that; main loop is blocked while it waits
+ * Intervals and banks are those of protocol/lufa/descriptor.h with and
+ * without USB_LOW_LATENCY_ENABLE.
+ *
+ * Latency is from when firmware has a report to when host takes it,
+ * including time the report waits for a previous send to return.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "host.h"
+
+
+typedef struct {
+    const char *name;
+    uint8_t interval;   /* ms */
+    uint8_t banks;
+} profile_t;
+
+static const profile_t profiles[] = {
+    { "10ms single bank", 10, 1 },  /* default */
+    { " 1ms single bank",  1, 1 },
+    { " 1ms double bank",  1, 2 },  /* USB_LOW_LATENCY_ENABLE */
+};
+
+
+/* Park-Miller: same sequences on every host */
+static uint32_t seed;
+static uint32_t rnd(uint32_t n)
+{
+    seed = (uint32_t)(((uint64_t)seed * 48271) % 2147483647);
+    return seed % n;
+}
+
+
+/* times(us) firmware has reports to send */
+#define MAX_EVENTS  20000
+static uint32_t events[MAX_EVENTS];
+static uint32_t event_count;
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* 8 keystrokes/s, each a press and a release report */
+static void gen_typing(void)
+{
+    uint32_t t = 0;
+    event_count = 0;
+    while (event_count < MAX_EVENTS) {
+        t += 1000 + rnd(248000);            // mean 125ms apart
+        events[event_count++] = t;
+        events[event_count++] = t + 30000 + rnd(90000);
+    }
+    qsort(events, event_count, sizeof(events[0]), cmp_u32);
+}
+
+/* press and release of a tap key decided in one scan, 200ms apart */
+static void gen_pairs(void)
+{
+    uint32_t t = 0;
+    event_count = 0;
+    while (event_count < MAX_EVENTS) {
+        t += 200000 + rnd(1000);
+        events[event_count++] = t;
+        events[event_count++] = t + 20;
+    }
+}
+
+/* macro of 20 reports with no wait, 200ms apart */
+static void gen_bursts(void)
+{
+    uint32_t t = 0;
+    event_count = 0;
+    while (event_count < MAX_EVENTS) {
+        t += 200000 + rnd(1000);
+        for (uint8_t i = 0; i < 20; i++) events[event_count++] = t + i * 100;
+    }
+}
+
+
+static uint32_t latency[MAX_EVENTS];
+static uint32_t latency_count;
+
+typedef struct {
+    double mean, blocked, blocked_max;
+    uint32_t p99;
+    long dropped;
+} result_t;
+
+static result_t run(const profile_t *p)
+{
+    const uint32_t interval = p->interval * 1000UL;
+    const uint32_t timeout = 255UL * 4 * p->interval;
+    uint32_t queue[2];
+    uint8_t queued = 0;
+    uint32_t next_poll = rnd(interval);
+    uint32_t free_at = 0;    // main loop is back from previous send
+    uint64_t blocked_sum = 0;
+    uint32_t blocked_max = 0;
+    result_t r = { 0 };
+
+    latency_count = 0;
+    for (uint32_t i = 0; i < event_count; i++) {
+        uint32_t ready = events[i];
+        uint32_t send_start = ready > free_at ? ready : free_at;
+        uint32_t deadline = send_start + timeout;
+        uint32_t t = send_start;
+
+        // host polls until send is called, and while it waits for a bank
+        while (next_poll <= t || (queued == p->banks && next_poll <= deadline)) {
+            if (next_poll > t) t = next_poll;
+            if (queued) {
+                latency[latency_count++] = next_poll - queue[0];
+                queue[0] = queue[1];
+                queued--;
+            }
+            next_poll += interval;
+        }
+        if (queued < p->banks) {
+            queue[queued++] = ready;
+        } else {
+            // Endpoint_IsReadWriteAllowed() stays false through the whole wait
+            t = deadline;
+            r.dropped++;
+        }
+        uint32_t blocked = t - send_start;
+        blocked_sum += blocked;
+        if (blocked > blocked_max) blocked_max = blocked;
+        free_at = t;
+    }
+    while (queued) {
+        latency[latency_count++] = next_poll - queue[0];
+        queue[0] = queue[1];
+        queued--;
+        next_poll += interval;
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < latency_count; i++) sum += latency[i];
+    qsort(latency, latency_count, sizeof(latency[0]), cmp_u32);
+    r.mean = (double)sum / latency_count / 1000;
+    r.p99 = latency[latency_count * 99 / 100];
+    r.blocked = (double)blocked_sum / event_count / 1000;
+    r.blocked_max = blocked_max / 1000.0;
+    return r;
+}
+
+
+static result_t results[3][3];
+
+static void load(const char *name, void (*gen)(void), result_t *res)
+{
+    printf("  %s:\n", name);
+    for (uint8_t i = 0; i < 3; i++) {
+        seed = 11;
+        gen();
+        res[i] = run(&profiles[i]);
+        printf("    %s: latency %5.2fms mean %5.2fms p99, send blocks %5.2fms mean %5.2fms max, %ld dropped\n",
+               profiles[i].name, res[i].mean, res[i].p99 / 1000.0,
+               res[i].blocked, res[i].blocked_max, res[i].dropped);
+    }
+}
+
+int main(void)
+{
+    printf("usb_polling: keyboard endpoint model\n");
+    load("typing, 8 keystrokes/s", gen_typing, results[0]);
+    load("press and release in one scan", gen_pairs, results[1]);
+    load("macro, 20 reports at once", gen_bursts, results[2]);
+
+    for (uint8_t l = 0; l < 3; l++) {
+        // waits time out at about one interval, so nothing is lost
+        for (uint8_t i = 0; i < 3; i++) CHECK(results[l][i].dropped == 0);
+        // 1ms polling is about ten times faster with either bank
+        CHECK(results[l][1].mean * 5 < results[l][0].mean);
+    }
+
+    // typing: a report is gone long before the next, banks make no difference
+    CHECK(results[0][1].blocked < 0.01 && results[0][2].blocked < 0.01);
+    // back-to-back pair: second report waits for a poll with single bank, not with double
+    CHECK(results[1][1].blocked_max > 0.5 && results[1][2].blocked_max == 0);
+    // host still takes one report a poll, so latency is the same
+    CHECK(results[1][2].p99 == results[1][1].p99);
+    // longer bursts still block with double bank, one interval less per burst
+    CHECK(results[2][2].blocked > 0 && results[2][2].blocked < results[2][1].blocked);
+
+    printf("%s\n", host_failures ? "FAILED" : "ok");
+    return host_failures != 0;
+}
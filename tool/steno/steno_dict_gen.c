@@ -0,0 +1,214 @@
+/*
+Copyright 2026 agent <agent@local>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * Steno dictionary compiler
+ *
+ * Reads a text dictionary and emits C source of hash table which
+ * common/steno.c looks up(see steno.h for the format). Input lines:
+ *
+ *     # comment
+ *     keys S- T- K- P- W- H- R- A- O- * -E -U -F -R -P -B -L -G -T -S -D -Z
+ *     T-+-E+-S+-T<TAB>test
+ *     0x00000003<TAB>chord given as bits
+ *
+ * 'keys' names bit 0, 1, 2... of chord in order. Chord is names joined with
+ * '+' or a number. Text is everything after the tab; \n, \t, \b and \\ are
+ * escapes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "steno.h"
+
+
+#define MAX_KEYS    32
+#define MAX_TEXT    255
+
+static char *keys[MAX_KEYS];
+static int key_count = 0;
+
+static struct entry {
+    uint32_t chord;
+    uint8_t  len;
+    char     text[MAX_TEXT];
+} *entries = NULL;
+static int entry_count = 0;
+
+
+static void die(int line, const char *msg, const char *arg)
+{
+    fprintf(stderr, "line %d: %s%s%s\n", line, msg, arg ? ": " : "", arg ? arg : "");
+    exit(1);
+}
+
+static uint32_t parse_chord(int line, char *s)
+{
+    if (strncmp(s, "0x", 2) == 0) {
+        return strtoul(s, NULL, 16);
+    }
+
+    uint32_t chord = 0;
+    for (char *name = strtok(s, "+"); name; name = strtok(NULL, "+")) {
+        int i = 0;
+        for (; i < key_count && strcmp(keys[i], name) != 0; i++)
+            ;
+        if (i == key_count) die(line, "unknown key", name);
+        chord |= 1UL<<i;
+    }
+    return chord;
+}
+
+static uint8_t parse_text(int line, const char *s, char *text)
+{
+    int len = 0;
+    for (; *s && *s != '\n' && *s != '\r'; s++) {
+        char c = *s;
+        if (c == '\\') {
+            switch (*++s) {
+                case 'n':  c = '\n'; break;
+                case 't':  c = '\t'; break;
+                case 'b':  c = '\b'; break;
+                case '\\': c = '\\'; break;
+                default:   die(line, "bad escape", NULL);
+            }
+        }
+        if (len == MAX_TEXT) die(line, "text too long", NULL);
+        text[len++] = c;
+    }
+    return len;
+}
+
+static void read_dict(FILE *f)
+{
+    char buf[1024];
+    int line = 0;
+
+    while (fgets(buf, sizeof(buf), f)) {
+        line++;
+        if (buf[0] == '#' || buf[0] == '\n' || buf[0] == '\r') continue;
+
+        if (strncmp(buf, "keys ", 5) == 0) {
+            key_count = 0;
+            for (char *name = strtok(buf + 5, " \t\r\n"); name; name = strtok(NULL, " \t\r\n")) {
+                if (key_count == MAX_KEYS) die(line, "too many keys", NULL);
+                keys[key_count++] = strdup(name);
+            }
+            continue;
+        }
+
+        char *tab = strchr(buf, '\t');
+        if (!tab) die(line, "no tab between chord and text", NULL);
+        *tab = '\0';
+
+        entries = realloc(entries, sizeof(struct entry) * (entry_count + 1));
+        struct entry *e = &entries[entry_count];
+        e->chord = parse_chord(line, buf);
+        e->len = parse_text(line, tab + 1, e->text);
+        for (int i = 0; i < entry_count; i++) {
+            if (entries[i].chord == e->chord) die(line, "duplicate chord", buf);
+        }
+        entry_count++;
+    }
+}
+
+static void emit(const char *source)
+{
+    /* load factor 3/4 at most */
+    int size = 8;
+    while (size * 3 < entry_count * 4) size *= 2;
+
+    uint32_t *offsets = malloc(sizeof(uint32_t) * entry_count);
+    uint32_t total = 0;
+    for (int i = 0; i < entry_count; i++) {
+        offsets[i] = total;
+        total += 5 + entries[i].len;
+    }
+    if (total >= STENO_DICT_EMPTY) {
+        fprintf(stderr, "dictionary too large: %u bytes\n", total);
+        exit(1);
+    }
+
+    uint16_t *slots = malloc(sizeof(uint16_t) * size);
+    int probes = 0, max_probes = 0;
+    for (int i = 0; i < size; i++) slots[i] = STENO_DICT_EMPTY;
+    for (int i = 0; i < entry_count; i++) {
+        int n = 1;
+        uint16_t h = steno_hash(entries[i].chord) & (size - 1);
+        for (; slots[h] != STENO_DICT_EMPTY; h = (h + 1) & (size - 1)) n++;
+        slots[h] = offsets[i];
+        probes += n;
+        if (n > max_probes) max_probes = n;
+    }
+
+    printf("/* Generated by tool/steno from %s. Do not edit. */\n", source);
+    printf("/* %d words, %u bytes of text, %d slots, probes mean %.2f max %d */\n",
+           entry_count, total, size, entry_count ? (double)probes / entry_count : 0, max_probes);
+    printf("#include <stdint.h>\n");
+    printf("#include <avr/pgmspace.h>\n");
+    printf("#include \"steno.h\"\n");
+    printf("\n");
+    printf("const uint16_t PROGMEM steno_dict_size = %d;\n\n", size);
+
+    printf("const uint16_t PROGMEM steno_dict_slots[] = {\n");
+    for (int i = 0; i < size; i++) {
+        if (i % 8 == 0) printf("    ");
+        printf("0x%04X,", slots[i]);
+        printf(((i + 1) % 8 == 0) ? "\n" : " ");
+    }
+    printf("};\n\n");
+
+    printf("const uint8_t PROGMEM steno_dict_entries[] = {\n");
+    for (int i = 0; i < entry_count; i++) {
+        struct entry *e = &entries[i];
+        printf("    0x%02X, 0x%02X, 0x%02X, 0x%02X, %u,",
+               e->chord & 0xFF, (e->chord >> 8) & 0xFF, (e->chord >> 16) & 0xFF, e->chord >> 24, e->len);
+        for (int j = 0; j < e->len; j++) {
+            unsigned char c = e->text[j];
+            if (c >= ' ' && c <= '~' && c != '\'' && c != '\\') {
+                printf(" '%c',", c);
+            } else {
+                printf(" 0x%02X,", c);
+            }
+        }
+        printf("\n");
+    }
+    printf("};\n");
+}
+
+int main(int argc, char **argv)
+{
+    FILE *f = stdin;
+    const char *source = "stdin";
+
+    if (argc > 2) {
+        fprintf(stderr, "Usage: %s [dictionary]\n", argv[0]);
+        return 1;
+    }
+    if (argc == 2) {
+        source = argv[1];
+        f = fopen(source, "r");
+        if (!f) {
+            perror(source);
+            return 1;
+        }
+    }
+    read_dict(f);
+    emit(source);
+    return 0;
+}